@@ -0,0 +1,189 @@
+// Cayley-Klein constructions (reflect, altitudes, orthocenter) per geometry
+
+mod common;
+
+use common::{objects, triangles, Rng, BATCH, MAGNITUDES};
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use projgeom_rs::*;
+use std::hint::black_box;
+
+fn bench_geometry<P, L>(
+    c: &mut Criterion,
+    name: &str,
+    new_p: fn([i128; 3]) -> P,
+    new_l: fn([i128; 3]) -> L,
+) where
+    P: CKPlane<L, i128>,
+    L: CKPlane<P, i128>,
+{
+    let mut rng = Rng::new(11);
+    for bits in MAGNITUDES {
+        let ps = objects(&mut rng, bits, new_p);
+        let ms = objects(&mut rng, bits, new_l);
+        let tris = triangles(&mut rng, bits, new_p);
+        let id = BenchmarkId::new(name, bits);
+
+        let mut group = c.benchmark_group("reflect");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for (m, p) in ms.iter().zip(&ps) {
+                    black_box(reflect(m, p));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("tri_altitude");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for tri in &tris {
+                    black_box(tri_altitude(tri));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("orthocenter");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id, |b| {
+            b.iter(|| {
+                for tri in &tris {
+                    black_box(orthocenter(tri));
+                }
+            })
+        });
+        group.finish();
+    }
+}
+
+fn bench_euclid_special(c: &mut Criterion) {
+    let mut rng = Rng::new(13);
+    for bits in MAGNITUDES {
+        let tris = triangles(&mut rng, bits, EuclidPoint::new);
+        let id = BenchmarkId::new("Euclid(special)", bits);
+
+        let mut group = c.benchmark_group("tri_altitude");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for tri in &tris {
+                    black_box(euclid_object::tri_altitude(tri));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("orthocenter");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id, |b| {
+            b.iter(|| {
+                for tri in &tris {
+                    black_box(euclid_object::orthocenter(tri));
+                }
+            })
+        });
+        group.finish();
+    }
+}
+
+/// Homogeneous vs affine representation of the same `z = 1` triangles
+fn bench_euclid_affine(c: &mut Criterion) {
+    use projgeom_rs::euclid_object::{try_affine_orthocenter, AffinePoint};
+    let mut rng = Rng::new(19);
+    for bits in MAGNITUDES {
+        let tris: Vec<[AffinePoint; 3]> = (0..BATCH)
+            .map(|_| [(); 3].map(|_| AffinePoint::new([rng.int(bits), rng.int(bits)])))
+            .collect();
+        let htris: Vec<[EuclidPoint; 3]> = tris.iter().map(|t| t.map(EuclidPoint::from)).collect();
+
+        let mut group = c.benchmark_group("euclid_affine");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(BenchmarkId::new("orthocenter(homogeneous)", bits), |b| {
+            b.iter(|| {
+                for tri in &htris {
+                    black_box(euclid_object::try_orthocenter(tri));
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("orthocenter(affine)", bits), |b| {
+            b.iter(|| {
+                for tri in &tris {
+                    black_box(try_affine_orthocenter(tri));
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("midpoint(homogeneous)", bits), |b| {
+            b.iter(|| {
+                for [p, q, _] in &htris {
+                    black_box(p.midpoint(q));
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("midpoint(affine)", bits), |b| {
+            b.iter(|| {
+                for [p, q, _] in &tris {
+                    black_box(p.midpoint(q));
+                }
+            })
+        });
+        group.finish();
+    }
+}
+
+/// One mirror, many points: per-point `reflect` against a prebuilt matrix
+fn bench_fixed_mirror(c: &mut Criterion) {
+    let mut rng = Rng::new(17);
+    for bits in MAGNITUDES {
+        let ps = objects(&mut rng, bits, HypPoint::new);
+        let mirror = HypLine::new(rng.coord(bits));
+        let batch = HypPointBatch::from_slice(&ps);
+        let h = Homography::reflect::<HypPoint, _>(&mirror);
+
+        let mut group = c.benchmark_group("reflect_fixed_mirror");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(BenchmarkId::new("reflect", bits), |b| {
+            b.iter(|| {
+                for p in &ps {
+                    black_box(reflect(&mirror, p));
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("Homography", bits), |b| {
+            b.iter(|| black_box(Homography::reflect::<HypPoint, _>(&mirror).apply_slice(&ps)))
+        });
+        group.bench_function(BenchmarkId::new("Homography(batch)", bits), |b| {
+            b.iter(|| black_box(batch.transform(&h)))
+        });
+        group.finish();
+    }
+}
+
+fn bench_ck_plane(c: &mut Criterion) {
+    bench_geometry(c, "Hyp", HypPoint::new, HypLine::new);
+    bench_geometry(c, "Ell", EllPoint::new, EllLine::new);
+    bench_geometry(c, "MyCK", MyCKPoint::new, MyCKLine::new);
+    bench_geometry(c, "Persp", PerspPoint::new, PerspLine::new);
+    bench_geometry(c, "Euclid", EuclidPoint::new, EuclidLine::new);
+    // matrix-driven polarities, to compare against the hand-written ones
+    use projgeom_rs::ck_polarity::{HypPolarity, MyCKPolarity};
+    bench_geometry(
+        c,
+        "HypPolar",
+        PolarPoint::<HypPolarity>::new,
+        PolarLine::new,
+    );
+    bench_geometry(
+        c,
+        "MyCKPolar",
+        PolarPoint::<MyCKPolarity>::new,
+        PolarLine::new,
+    );
+    bench_euclid_special(c);
+    bench_euclid_affine(c);
+    bench_fixed_mirror(c);
+}
+
+criterion_group!(benches, bench_ck_plane);
+criterion_main!(benches);
@@ -0,0 +1,75 @@
+// Shared workload generation for the benchmarks
+//
+// Inputs are deterministic (fixed-seed xorshift) so runs are comparable
+// across builds. Coordinates are drawn from [-2^bits, 2^bits]; `MAGNITUDES`
+// lists the widths each benchmark is run at, chosen so the deepest
+// construction (Desargues on the dual triangles, degree 12 in the inputs)
+// still fits in i128.
+
+#![allow(dead_code)]
+
+use projgeom_rs::{coincident, ProjPlanePrim};
+
+/// Number of inputs processed per benchmark iteration
+pub const BATCH: usize = 256;
+
+/// Coordinate bit widths
+pub const MAGNITUDES: [u32; 3] = [4, 6, 8];
+
+pub struct Rng(u64);
+
+impl Rng {
+    pub fn new(seed: u64) -> Self {
+        Self(seed.wrapping_mul(0x9E37_79B9_7F4A_7C15) | 1)
+    }
+
+    pub fn next_u64(&mut self) -> u64 {
+        let mut x = self.0;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        self.0 = x;
+        x
+    }
+
+    /// Uniform in [-2^bits, 2^bits]
+    pub fn int(&mut self, bits: u32) -> i128 {
+        let span = (1u64 << (bits + 1)) + 1;
+        (self.next_u64() % span) as i128 - (1i128 << bits)
+    }
+
+    /// Non-zero homogeneous coordinate
+    pub fn coord(&mut self, bits: u32) -> [i128; 3] {
+        loop {
+            let c = [self.int(bits), self.int(bits), self.int(bits)];
+            if c != [0, 0, 0] {
+                return c;
+            }
+        }
+    }
+}
+
+/// `BATCH` objects built by `new`
+pub fn objects<P>(rng: &mut Rng, bits: u32, new: fn([i128; 3]) -> P) -> Vec<P> {
+    (0..BATCH).map(|_| new(rng.coord(bits))).collect()
+}
+
+/// `BATCH` non-degenerate triangles built by `new`
+pub fn triangles<P, L>(rng: &mut Rng, bits: u32, new: fn([i128; 3]) -> P) -> Vec<[P; 3]>
+where
+    P: ProjPlanePrim<L>,
+    L: ProjPlanePrim<P>,
+{
+    let mut res = Vec::with_capacity(BATCH);
+    while res.len() < BATCH {
+        let tri = [
+            new(rng.coord(bits)),
+            new(rng.coord(bits)),
+            new(rng.coord(bits)),
+        ];
+        if !coincident(&tri[0], &tri[1], &tri[2]) {
+            res.push(tri);
+        }
+    }
+    res
+}
@@ -0,0 +1,56 @@
+// Cost of the fixed-object and temporary-heavy paths now that the point and
+// line types are `Copy`: `perp` onto the constant line at infinity, `aux`,
+// and `tri_dual` taken by reference (library) versus by value.
+
+use criterion::{criterion_group, criterion_main, Criterion};
+use projgeom_rs::*;
+use std::hint::black_box;
+
+#[inline]
+fn tri_dual_by_value<P, L>(tri: [P; 3]) -> [L; 3]
+where
+    P: ProjPlanePrim<L> + Copy,
+    L: ProjPlanePrim<P>,
+{
+    let [a1, a2, a3] = tri;
+    assert!(!coincident(&a1, &a2, &a3));
+    [a2.circ(&a3), a1.circ(&a3), a1.circ(&a2)]
+}
+
+fn bench_perp(c: &mut Criterion) {
+    let mut group = c.benchmark_group("perp");
+    let p = EuclidPoint::new([13, 23, 32]);
+    let q = PerspPoint::new([13, 23, 32]);
+    let l = PerspLine::new([44, -34, 2]);
+    group.bench_function("EuclidPoint::perp", |b| b.iter(|| black_box(&p).perp()));
+    group.bench_function("PerspPoint::perp", |b| b.iter(|| black_box(&q).perp()));
+    group.bench_function("PerspLine::perp", |b| b.iter(|| black_box(&l).perp()));
+    group.bench_function("PgPoint::aux", |b| {
+        let p = PgPoint::new([13, 23, 32]);
+        b.iter(|| black_box(&p).aux())
+    });
+    group.finish();
+}
+
+fn bench_tri_dual(c: &mut Criterion) {
+    let mut group = c.benchmark_group("tri_dual");
+    let tri = [
+        PgPoint::new([13, 23, 32]),
+        PgPoint::new([44, -34, 2]),
+        PgPoint::new([-2, 12, 23]),
+    ];
+    group.bench_function("by_ref", |b| b.iter(|| tri_dual(black_box(&tri))));
+    group.bench_function("by_value", |b| b.iter(|| tri_dual_by_value(black_box(tri))));
+    let tri = [
+        EuclidPoint::new([13, 23, 32]),
+        EuclidPoint::new([44, -34, 2]),
+        EuclidPoint::new([-2, 12, 23]),
+    ];
+    group.bench_function("euclid_tri_altitude", |b| {
+        b.iter(|| euclid_object::tri_altitude(black_box(&tri)))
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_perp, bench_tri_dual);
+criterion_main!(benches);
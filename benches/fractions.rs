@@ -0,0 +1,126 @@
+// Fraction arithmetic at several numerator/denominator magnitudes
+
+mod common;
+
+use common::{Rng, BATCH};
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use projgeom_rs::{Fraction, FractionVec, LazyFraction};
+use std::hint::black_box;
+
+/// Numerator/denominator bit widths
+const FRACTION_MAGNITUDES: [u32; 3] = [8, 16, 24];
+
+fn fractions(rng: &mut Rng, bits: u32) -> Vec<Fraction<i64>> {
+    (0..BATCH)
+        .map(|_| {
+            let num = rng.int(bits) as i64;
+            let den = (rng.int(bits) as i64).abs() + 1;
+            Fraction::new(num, den)
+        })
+        .collect()
+}
+
+/// Fractions whose denominators divide 720720, so running sums stay bounded
+fn summable(rng: &mut Rng, bits: u32) -> Vec<Fraction<i64>> {
+    const DENS: [i64; 12] = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 13];
+    (0..BATCH)
+        .map(|_| {
+            let num = rng.int(bits) as i64;
+            let den = DENS[(rng.next_u64() % 12) as usize];
+            Fraction::new(num, den)
+        })
+        .collect()
+}
+
+fn bench_fractions(c: &mut Criterion) {
+    let mut rng = Rng::new(17);
+    for bits in FRACTION_MAGNITUDES {
+        let fs = fractions(&mut rng, bits);
+        let gs = fractions(&mut rng, bits);
+        let ss = summable(&mut rng, bits);
+        let mut group = c.benchmark_group("fraction");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(BenchmarkId::new("add", bits), |b| {
+            b.iter(|| {
+                for (f, g) in fs.iter().zip(&gs) {
+                    black_box(*f + *g);
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("sub", bits), |b| {
+            b.iter(|| {
+                for (f, g) in fs.iter().zip(&gs) {
+                    black_box(*f - *g);
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("mul", bits), |b| {
+            b.iter(|| {
+                for (f, g) in fs.iter().zip(&gs) {
+                    black_box(*f * *g);
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("cmp", bits), |b| {
+            b.iter(|| {
+                for (f, g) in fs.iter().zip(&gs) {
+                    black_box(f.cmp(g));
+                }
+            })
+        });
+        group.bench_function(BenchmarkId::new("sum", bits), |b| {
+            b.iter(|| ss.iter().fold(Fraction::new(0, 1), |acc, f| acc + *f))
+        });
+        group.bench_function(BenchmarkId::new("lazy_sum", bits), |b| {
+            b.iter(|| {
+                ss.iter()
+                    .fold(LazyFraction::new(0, 1), |acc, f| {
+                        acc + LazyFraction::from(*f)
+                    })
+                    .to_fraction()
+            })
+        });
+        group.finish();
+
+        // element-wise ops on values sharing a denominator, as in a mesh of
+        // quadrances over one normalizing factor
+        let den = (rng.int(bits) as i64).abs() + 1;
+        let nums =
+            |rng: &mut Rng| -> Vec<i64> { (0..BATCH).map(|_| rng.int(bits) as i64).collect() };
+        let (us, vs) = (nums(&mut rng), nums(&mut rng));
+        let (uf, vf): (Vec<Fraction<i64>>, Vec<_>) = us
+            .iter()
+            .zip(&vs)
+            .map(|(u, v)| (Fraction::new(*u, den), Fraction::new(*v, den)))
+            .unzip();
+        let (uv, vv) = (FractionVec::new(us, den), FractionVec::new(vs, den));
+        let mut group = c.benchmark_group("fraction_vec");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(BenchmarkId::new("Fraction/add", bits), |b| {
+            b.iter(|| {
+                let res: Vec<_> = uf.iter().zip(&vf).map(|(f, g)| *f + *g).collect();
+                black_box(res)
+            })
+        });
+        group.bench_function(BenchmarkId::new("FractionVec/add", bits), |b| {
+            b.iter(|| {
+                let mut res = uv.clone();
+                res += &vv;
+                black_box(res)
+            })
+        });
+        group.bench_function(BenchmarkId::new("Fraction/cmp", bits), |b| {
+            b.iter(|| {
+                let res: Vec<_> = uf.iter().zip(&vf).map(|(f, g)| f.cmp(g)).collect();
+                black_box(res)
+            })
+        });
+        group.bench_function(BenchmarkId::new("FractionVec/cmp", bits), |b| {
+            b.iter(|| black_box(uv.cmp_many(&vv)))
+        });
+        group.finish();
+    }
+}
+
+criterion_group!(benches, bench_fractions);
+criterion_main!(benches);
@@ -0,0 +1,198 @@
+// Projective plane primitives and theorem checks for every geometry
+
+mod common;
+
+use common::{objects, triangles, Rng, BATCH, MAGNITUDES};
+use criterion::{criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use projgeom_rs::*;
+use std::hint::black_box;
+
+fn bench_geometry<P, L>(
+    c: &mut Criterion,
+    name: &str,
+    new_p: fn([i128; 3]) -> P,
+    new_l: fn([i128; 3]) -> L,
+) where
+    P: ProjPlane<L, i128>,
+    L: ProjPlane<P, i128>,
+{
+    let mut rng = Rng::new(7);
+    for bits in MAGNITUDES {
+        let ps = objects(&mut rng, bits, new_p);
+        let qs = objects(&mut rng, bits, new_p);
+        let ls = objects(&mut rng, bits, new_l);
+        let ld: Vec<i128> = (0..BATCH).map(|_| rng.int(bits)).collect();
+        let mu: Vec<i128> = (0..BATCH).map(|_| rng.int(bits)).collect();
+        // collinear triples for harm_conj
+        let rs: Vec<P> = (0..BATCH)
+            .map(|i| ps[i].plucker(&ld[i], &qs[i], &mu[i]))
+            .collect();
+        let id = BenchmarkId::new(name, bits);
+
+        let mut group = c.benchmark_group("circ");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for (p, q) in ps.iter().zip(&qs) {
+                    black_box(p.circ(q));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("incident");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for (p, l) in ps.iter().zip(&ls) {
+                    black_box(p.incident(l));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("plucker");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for i in 0..BATCH {
+                    black_box(ps[i].plucker(&ld[i], &qs[i], &mu[i]));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("harm_conj");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for i in 0..BATCH {
+                    black_box(harm_conj(&ps[i], &qs[i], &rs[i]));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("involution");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for i in 0..BATCH {
+                    black_box(involution(&ps[i], &ls[i], &qs[i]));
+                }
+            })
+        });
+        group.finish();
+
+        let tri1 = triangles(&mut rng, bits, new_p);
+        let tri2 = triangles(&mut rng, bits, new_p);
+        let mut group = c.benchmark_group("check_pappus");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id.clone(), |b| {
+            b.iter(|| {
+                for (t1, t2) in tri1.iter().zip(&tri2) {
+                    black_box(check_pappus(t1, t2));
+                }
+            })
+        });
+        group.finish();
+
+        let mut group = c.benchmark_group("check_desargue");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(id, |b| {
+            b.iter(|| {
+                for (t1, t2) in tri1.iter().zip(&tri2) {
+                    black_box(check_desargue(t1, t2));
+                }
+            })
+        });
+        group.finish();
+    }
+}
+
+/// Theorem checks as exact yes/no tests over i128 versus modular residues
+fn bench_modular(c: &mut Criterion) {
+    type Tris = [[PgPoint; 3]];
+
+    fn check<T: Scalar + From<i128>>(c: &mut Criterion, name: &str, tri1: &Tris, tri2: &Tris) {
+        let reduce = |tris: &Tris| -> Vec<[PgPointT<T>; 3]> {
+            tris.iter()
+                .map(|t| t.map(|p| PgPointT::new(p.coord.map(T::from))))
+                .collect()
+        };
+        let (tri1, tri2) = (reduce(tri1), reduce(tri2));
+        for (group_name, f) in [
+            (
+                "check_pappus",
+                check_pappus::<PgPointT<T>, PgLineT<T>> as fn(&_, &_) -> bool,
+            ),
+            ("check_desargue", check_desargue::<PgPointT<T>, PgLineT<T>>),
+        ] {
+            let mut group = c.benchmark_group(group_name);
+            group.throughput(Throughput::Elements(BATCH as u64));
+            group.bench_function(BenchmarkId::new(name, 8), |b| {
+                b.iter(|| {
+                    for (t1, t2) in tri1.iter().zip(&tri2) {
+                        black_box(f(t1, t2));
+                    }
+                })
+            });
+            group.finish();
+        }
+    }
+
+    let mut rng = Rng::new(7);
+    let tri1 = triangles(&mut rng, 8, PgPoint::new);
+    let tri2 = triangles(&mut rng, 8, PgPoint::new);
+    check::<i128>(c, "Pg/i128", &tri1, &tri2);
+    check::<Mod61>(c, "Pg/Mod61", &tri1, &tri2);
+    check::<MultiModP>(c, "Pg/MultiModP", &tri1, &tri2);
+}
+
+/// Batch joins in i128 versus columns kept in the width picked by `autotune`
+fn bench_autotune(c: &mut Criterion) {
+    let mut rng = Rng::new(23);
+    for bits in [8, 20, 40] {
+        let ps: Vec<PgPoint> = (0..BATCH).map(|_| PgPoint::new(rng.coord(bits))).collect();
+        let qs: Vec<PgPoint> = (0..BATCH).map(|_| PgPoint::new(rng.coord(bits))).collect();
+        let mut group = c.benchmark_group("circ_many");
+        group.throughput(Throughput::Elements(BATCH as u64));
+        group.bench_function(BenchmarkId::new("i128", bits), |b| {
+            b.iter(|| {
+                black_box(
+                    ps.iter()
+                        .zip(&qs)
+                        .map(|(p, q)| p.circ(q))
+                        .collect::<Vec<PgLine>>(),
+                )
+            })
+        });
+        macro_rules! narrow {
+            ($t:ty) => {{
+                let pb = autotune::narrow_batch::<$t, _>(&ps).unwrap();
+                let qb = autotune::narrow_batch::<$t, _>(&qs).unwrap();
+                group.bench_function(BenchmarkId::new("narrow", bits), |b| {
+                    b.iter(|| black_box(pb.circ_many(&qb)))
+                });
+            }};
+        }
+        match autotune::circ_width(&ps, &qs) {
+            Some(autotune::Width::I32) => narrow!(i32),
+            Some(autotune::Width::I64) => narrow!(i64),
+            _ => narrow!(i128),
+        }
+        group.finish();
+    }
+}
+
+fn bench_pg_plane(c: &mut Criterion) {
+    bench_geometry(c, "Pg", PgPoint::new, PgLine::new);
+    bench_geometry(c, "Hyp", HypPoint::new, HypLine::new);
+    bench_geometry(c, "Ell", EllPoint::new, EllLine::new);
+    bench_geometry(c, "MyCK", MyCKPoint::new, MyCKLine::new);
+    bench_geometry(c, "Persp", PerspPoint::new, PerspLine::new);
+    bench_geometry(c, "Euclid", EuclidPoint::new, EuclidLine::new);
+}
+
+criterion_group!(benches, bench_pg_plane, bench_modular, bench_autotune);
+criterion_main!(benches);
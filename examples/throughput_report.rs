@@ -0,0 +1,602 @@
+// Per-geometry throughput report
+//
+// Runs the construction primitives of every geometry on fixed-seed random
+// inputs, through each evaluation path (scalar loop, SoA batch, SoA batch
+// narrowed by `autotune` to i32 or i64 when the joins fit and, with the
+// `parallel` feature, the rayon versions), and prints one JSON document on
+// stdout so that runs of different builds can be diffed:
+//
+//     cargo run --release --example throughput_report [--features parallel] -- \
+//         [--bits N] [--len N] [--ms N]
+//
+// `--bits` is the input coordinate width (default 8), `--len` the number of
+// inputs per batch (default 4096, above `pg_parallel::MIN_LEN`) and `--ms`
+// the minimum measuring time per row (default 100). Every row has the rate
+// (ops/sec, ns/op), the heap allocations and bytes per op seen by a counting
+// global allocator, and the bit lengths of the output coordinates (largest
+// and mean), which is where coordinate growth shows up. Predicates have no
+// output coordinates and report `null` there.
+
+use projgeom_rs::ck_plane::try_orthocenter;
+use projgeom_rs::pg_batch::*;
+use projgeom_rs::verifier::Xorshift;
+use projgeom_rs::*;
+use std::alloc::{GlobalAlloc, Layout, System};
+use std::fmt::Write;
+use std::hint::black_box;
+use std::sync::atomic::{AtomicU64, Ordering::Relaxed};
+use std::time::{Duration, Instant};
+
+/// System allocator that counts allocations
+struct Counting;
+
+static ALLOCS: AtomicU64 = AtomicU64::new(0);
+static BYTES: AtomicU64 = AtomicU64::new(0);
+
+unsafe impl GlobalAlloc for Counting {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        ALLOCS.fetch_add(1, Relaxed);
+        BYTES.fetch_add(layout.size() as u64, Relaxed);
+        System.alloc(layout)
+    }
+
+    unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+        System.dealloc(ptr, layout)
+    }
+
+    unsafe fn realloc(&self, ptr: *mut u8, layout: Layout, new_size: usize) -> *mut u8 {
+        ALLOCS.fetch_add(1, Relaxed);
+        BYTES.fetch_add(new_size as u64, Relaxed);
+        System.realloc(ptr, layout, new_size)
+    }
+}
+
+#[global_allocator]
+static GLOBAL: Counting = Counting;
+
+struct Config {
+    bits: u32,
+    len: usize,
+    min_time: Duration,
+}
+
+impl Config {
+    fn from_args() -> Self {
+        let mut cfg = Self {
+            bits: 8,
+            len: 4096,
+            min_time: Duration::from_millis(100),
+        };
+        let mut args = std::env::args().skip(1);
+        while let Some(arg) = args.next() {
+            let mut value = || -> u64 {
+                let v = args.next().unwrap_or_default();
+                v.parse()
+                    .unwrap_or_else(|_| panic!("{arg}: expected a number, got {v:?}"))
+            };
+            match arg.as_str() {
+                "--bits" => cfg.bits = value() as u32,
+                "--len" => cfg.len = value() as usize,
+                "--ms" => cfg.min_time = Duration::from_millis(value()),
+                _ => panic!("unknown argument {arg:?}"),
+            }
+        }
+        assert!(
+            cfg.bits <= 16,
+            "--bits: orthocenters overflow i128 past 16 bits"
+        );
+        assert!(cfg.len > 0, "--len must be positive");
+        cfg
+    }
+}
+
+/// Bit lengths of output coordinates
+#[derive(Default)]
+struct Growth {
+    max: u32,
+    sum: u64,
+    n: u64,
+}
+
+impl Growth {
+    fn of<C: AsRef<[i128; 3]>>(objs: &[C]) -> Option<Self> {
+        let mut res = Self::default();
+        for c in objs.iter().flat_map(|o| o.as_ref()) {
+            let b = c.bit_len();
+            res.max = res.max.max(b);
+            res.sum += b as u64;
+            res.n += 1;
+        }
+        Some(res)
+    }
+}
+
+struct Row {
+    geometry: &'static str,
+    op: &'static str,
+    path: &'static str,
+    ops: u64,
+    elapsed: Duration,
+    allocs: u64,
+    bytes: u64,
+    growth: Option<Growth>,
+}
+
+struct Report {
+    cfg: Config,
+    rows: Vec<Row>,
+}
+
+impl Report {
+    /// Time `f`, which performs `per_call` ops, until `min_time` has passed
+    ///
+    /// `growth` is taken from the output of the last call.
+    fn measure<R>(
+        &mut self,
+        (geometry, op, path): (&'static str, &'static str, &'static str),
+        per_call: usize,
+        mut f: impl FnMut() -> R,
+        growth: impl FnOnce(&R) -> Option<Growth>,
+    ) {
+        let mut out = f(); // warm up
+        let (allocs, bytes) = (ALLOCS.load(Relaxed), BYTES.load(Relaxed));
+        let begin = Instant::now();
+        let mut calls = 0;
+        loop {
+            drop(black_box(out));
+            out = f();
+            calls += 1;
+            if begin.elapsed() >= self.cfg.min_time {
+                break;
+            }
+        }
+        let elapsed = begin.elapsed();
+        let (allocs, bytes) = (ALLOCS.load(Relaxed) - allocs, BYTES.load(Relaxed) - bytes);
+        self.rows.push(Row {
+            geometry,
+            op,
+            path,
+            ops: calls * per_call as u64,
+            elapsed,
+            allocs,
+            bytes,
+            growth: growth(&out),
+        });
+    }
+
+    fn to_json(&self) -> String {
+        let mut features = Vec::new();
+        if cfg!(feature = "parallel") {
+            features.push("\"parallel\"");
+        }
+        if cfg!(feature = "metrics") {
+            features.push("\"metrics\"");
+        }
+        let mut s = String::new();
+        s.push_str("{\n");
+        let _ = writeln!(s, "  \"version\": \"{}\",", env!("CARGO_PKG_VERSION"));
+        let _ = writeln!(s, "  \"features\": [{}],", features.join(", "));
+        let _ = writeln!(s, "  \"bits\": {},", self.cfg.bits);
+        let _ = writeln!(s, "  \"len\": {},", self.cfg.len);
+        s.push_str("  \"rows\": [\n");
+        for (i, r) in self.rows.iter().enumerate() {
+            let ops = r.ops as f64;
+            let secs = r.elapsed.as_secs_f64();
+            let _ = write!(
+                s,
+                "    {{\"geometry\": \"{}\", \"op\": \"{}\", \"path\": \"{}\", \
+                 \"ops\": {}, \"ops_per_sec\": {:.1}, \"ns_per_op\": {:.3}, \
+                 \"allocs_per_op\": {:.4}, \"bytes_per_op\": {:.2}, ",
+                r.geometry,
+                r.op,
+                r.path,
+                r.ops,
+                ops / secs,
+                secs * 1e9 / ops,
+                r.allocs as f64 / ops,
+                r.bytes as f64 / ops,
+            );
+            match &r.growth {
+                Some(g) => {
+                    let _ = write!(
+                        s,
+                        "\"max_bits\": {}, \"mean_bits\": {:.2}}}",
+                        g.max,
+                        g.sum as f64 / g.n.max(1) as f64
+                    );
+                }
+                None => s.push_str("\"max_bits\": null, \"mean_bits\": null}"),
+            }
+            s.push_str(if i + 1 < self.rows.len() { ",\n" } else { "\n" });
+        }
+        s.push_str("  ]\n}\n");
+        s
+    }
+}
+
+/// Raw inputs shared by every geometry
+struct Workload {
+    ps: Vec<[i128; 3]>,
+    qs: Vec<[i128; 3]>,
+    rs: Vec<[i128; 3]>,
+    ss: Vec<[i128; 3]>,
+    ld: Vec<i128>,
+    mu: Vec<i128>,
+    /// Candidate triangles; each geometry keeps its non-degenerate ones
+    tris: Vec<[[i128; 3]; 3]>,
+}
+
+impl Workload {
+    fn new(cfg: &Config) -> Self {
+        let mut rng = Xorshift::new(2024);
+        let (n, bits) = (cfg.len, cfg.bits);
+        let coords = |rng: &mut Xorshift| (0..n).map(|_| rng.coord(bits)).collect::<Vec<_>>();
+        let (ps, qs, rs, ss) = (
+            coords(&mut rng),
+            coords(&mut rng),
+            coords(&mut rng),
+            coords(&mut rng),
+        );
+        let ld = (0..n).map(|_| rng.int(bits)).collect();
+        let mu = (0..n).map(|_| rng.int(bits)).collect();
+        let tris = (0..n)
+            .map(|_| [rng.coord(bits), rng.coord(bits), rng.coord(bits)])
+            .collect();
+        Self {
+            ps,
+            qs,
+            rs,
+            ss,
+            ld,
+            mu,
+            tris,
+        }
+    }
+}
+
+/// Inputs of one geometry
+struct Objects<P, L> {
+    ps: Vec<P>,
+    qs: Vec<P>,
+    rs: Vec<P>,
+    ss: Vec<P>,
+    ls: Vec<L>,
+}
+
+impl<P, L> Objects<P, L>
+where
+    P: ProjPlanePrim<L>,
+    L: ProjPlanePrim<P>,
+{
+    fn new(w: &Workload, new: fn([i128; 3]) -> P) -> Self {
+        let ps: Vec<P> = w.ps.iter().map(|c| new(*c)).collect();
+        let qs: Vec<P> = w.qs.iter().map(|c| new(*c)).collect();
+        // lines through `ps`, so that half of the incidence tests succeed
+        let ls = ps
+            .iter()
+            .zip(&qs)
+            .enumerate()
+            .map(|(i, (p, q))| {
+                if i % 2 == 0 {
+                    p.circ(q)
+                } else {
+                    q.circ(&qs[(i + 1) % qs.len()])
+                }
+            })
+            .collect();
+        Self {
+            ps,
+            qs,
+            rs: w.rs.iter().map(|c| new(*c)).collect(),
+            ss: w.ss.iter().map(|c| new(*c)).collect(),
+            ls,
+        }
+    }
+}
+
+/// Runs the narrow row `$f::<T, P, L>` in the lane of `$width`; none in
+/// i128, which is the "batch" row
+macro_rules! in_lane {
+    ($width:expr, $f:ident($($arg:expr),*)) => {
+        match $width {
+            Some(autotune::Width::I32) => $f::<i32, P, L>($($arg),*),
+            Some(autotune::Width::I64) => $f::<i64, P, L>($($arg),*),
+            _ => {}
+        }
+    };
+}
+
+/// Scalar and parallel rows of the projective primitives
+fn projective<P, L>(rep: &mut Report, geometry: &'static str, w: &Workload, o: &Objects<P, L>)
+where
+    P: ProjPlane<L, i128> + AsRef<[i128; 3]> + From<[i128; 3]> + Sync + Send,
+    L: ProjPlane<P, i128> + AsRef<[i128; 3]> + From<[i128; 3]> + Sync + Send,
+{
+    let n = o.ps.len();
+    let (ps, qs, rs, ss, ls) = (&o.ps, &o.qs, &o.rs, &o.ss, &o.ls);
+    rep.measure(
+        (geometry, "join", "scalar"),
+        n,
+        || {
+            ps.iter()
+                .zip(qs)
+                .map(|(p, q)| p.circ(q))
+                .collect::<Vec<L>>()
+        },
+        |r| Growth::of(r),
+    );
+    rep.measure(
+        (geometry, "incident", "scalar"),
+        n,
+        || {
+            ps.iter()
+                .zip(ls)
+                .map(|(p, l)| p.incident(l))
+                .collect::<Vec<bool>>()
+        },
+        |_| None,
+    );
+    // degree 4 in the inputs: (p v q) ^ (r v s)
+    rep.measure(
+        (geometry, "meet_of_joins", "scalar"),
+        n,
+        || {
+            (0..n)
+                .map(|i| ps[i].circ(&qs[i]).circ(&rs[i].circ(&ss[i])))
+                .collect::<Vec<P>>()
+        },
+        |r| Growth::of(r),
+    );
+    rep.measure(
+        (geometry, "plucker", "scalar"),
+        n,
+        || {
+            (0..n)
+                .map(|i| ps[i].plucker(&w.ld[i], &qs[i], &w.mu[i]))
+                .collect::<Vec<P>>()
+        },
+        |r| Growth::of(r),
+    );
+    in_lane!(autotune::circ_width(ps, qs), narrow_join(rep, geometry, o));
+    in_lane!(
+        autotune::incident_width(ps, ls),
+        narrow_incident(rep, geometry, o)
+    );
+    in_lane!(
+        autotune::plucker_width(&w.ld, ps, &w.mu, qs),
+        narrow_plucker(rep, geometry, w, o)
+    );
+    #[cfg(feature = "parallel")]
+    {
+        use projgeom_rs::pg_parallel::{par_circ, par_incident};
+        rep.measure(
+            (geometry, "join", "parallel"),
+            n,
+            || par_circ::<P, L>(ps, qs),
+            |r| Growth::of(r),
+        );
+        rep.measure(
+            (geometry, "incident", "parallel"),
+            n,
+            || par_incident(ps, ls),
+            |_| None,
+        );
+        rep.measure(
+            (geometry, "meet_of_joins", "parallel"),
+            n,
+            || par_circ::<L, P>(&par_circ(ps, qs), &par_circ(rs, ss)),
+            |r| Growth::of(r),
+        );
+    }
+}
+
+/// Rows of the Cayley-Klein constructions
+fn cayley_klein<P, L>(
+    rep: &mut Report,
+    geometry: &'static str,
+    w: &Workload,
+    new: fn([i128; 3]) -> P,
+) where
+    P: CKPlanePrim<L> + AsRef<[i128; 3]> + Sync + Send,
+    L: CKPlanePrim<P> + AsRef<[i128; 3]> + Sync + Send,
+{
+    let tris: Vec<[P; 3]> = w
+        .tris
+        .iter()
+        .map(|t| t.map(new))
+        .filter(|t| try_orthocenter(t).is_some())
+        .collect();
+    rep.measure(
+        (geometry, "orthocenter", "scalar"),
+        tris.len(),
+        || tris.iter().map(orthocenter).collect::<Vec<P>>(),
+        |r| Growth::of(r),
+    );
+    #[cfg(feature = "parallel")]
+    rep.measure(
+        (geometry, "orthocenter", "parallel"),
+        tris.len(),
+        || projgeom_rs::pg_parallel::par_orthocenter::<P, L>(&tris),
+        |r| Growth::of(r),
+    );
+}
+
+/// Columns of `cs` narrowed once to `T` (see `autotune::narrow_batch`)
+fn narrow<T: autotune::Lane, C: AsRef<[i128; 3]>>(cs: &[C]) -> PgPointBatchT<T> {
+    autotune::narrow_batch(cs).expect("narrow_batch: too wide")
+}
+
+/// Batch join row on narrowed columns
+fn narrow_join<T, P, L>(rep: &mut Report, geometry: &'static str, o: &Objects<P, L>)
+where
+    T: autotune::Lane,
+    P: AsRef<[i128; 3]>,
+    L: AsRef<[i128; 3]> + From<[i128; 3]>,
+{
+    let (pb, qb) = (narrow::<T, _>(&o.ps), narrow::<T, _>(&o.qs));
+    rep.measure(
+        (geometry, "join", "narrow"),
+        o.ps.len(),
+        || pb.circ_many(&qb),
+        |r| Growth::of(&autotune::widen_many::<T, L>([&r.x, &r.y, &r.z])),
+    );
+}
+
+/// Batch incidence row on narrowed columns
+fn narrow_incident<T, P, L>(rep: &mut Report, geometry: &'static str, o: &Objects<P, L>)
+where
+    T: autotune::Lane,
+    P: AsRef<[i128; 3]>,
+    L: AsRef<[i128; 3]>,
+{
+    let (pb, lines) = (narrow::<T, _>(&o.ps), narrow::<T, _>(&o.ls));
+    let lb = PgLineBatchT {
+        x: lines.x,
+        y: lines.y,
+        z: lines.z,
+    };
+    rep.measure(
+        (geometry, "incident", "narrow"),
+        o.ps.len(),
+        || pb.incident_mask(&lb),
+        |_| None,
+    );
+}
+
+/// Batch Plucker row on narrowed columns
+fn narrow_plucker<T, P, L>(
+    rep: &mut Report,
+    geometry: &'static str,
+    w: &Workload,
+    o: &Objects<P, L>,
+) where
+    T: autotune::Lane,
+    P: AsRef<[i128; 3]> + From<[i128; 3]>,
+{
+    let (pb, qb) = (narrow::<T, _>(&o.ps), narrow::<T, _>(&o.qs));
+    let scalars = |vs: &[i128]| -> Vec<T> {
+        vs.iter()
+            .map(|v| T::try_from(*v).ok().expect("narrow: too wide"))
+            .collect()
+    };
+    let (ld, mu) = (scalars(&w.ld), scalars(&w.mu));
+    rep.measure(
+        (geometry, "plucker", "narrow"),
+        o.ps.len(),
+        || pb.plucker_many(&ld, &qb, &mu),
+        |r| Growth::of(&autotune::widen_many::<T, P>([&r.x, &r.y, &r.z])),
+    );
+}
+
+/// Rows of one geometry; the batch types are concrete, hence the macro
+macro_rules! geometry {
+    ($rep:expr, $w:expr, $name:literal, $point:ident, $line:ident, $pbatch:ident, $lbatch:ident) => {{
+        let o = Objects::<$point, $line>::new($w, $point::new);
+        projective($rep, $name, $w, &o);
+        let n = o.ps.len();
+        let (pb, qb) = ($pbatch::from_slice(&o.ps), $pbatch::from_slice(&o.qs));
+        let (rb, sb) = ($pbatch::from_slice(&o.rs), $pbatch::from_slice(&o.ss));
+        let lb = $lbatch::from_slice(&o.ls);
+        $rep.measure(
+            ($name, "join", "batch"),
+            n,
+            || pb.circ_many(&qb),
+            |r| Growth::of(&r.to_vec()),
+        );
+        $rep.measure(
+            ($name, "incident", "batch"),
+            n,
+            || pb.incident_mask(&lb),
+            |_| None,
+        );
+        $rep.measure(
+            ($name, "meet_of_joins", "batch"),
+            n,
+            || pb.circ_many(&qb).circ_many(&rb.circ_many(&sb)),
+            |r| Growth::of(&r.to_vec()),
+        );
+        $rep.measure(
+            ($name, "plucker", "batch"),
+            n,
+            || pb.plucker_many(&$w.ld, &qb, &$w.mu),
+            |r| Growth::of(&r.to_vec()),
+        );
+        #[cfg(feature = "parallel")]
+        {
+            $rep.measure(
+                ($name, "join", "parallel_batch"),
+                n,
+                || pb.par_circ_many(&qb),
+                |r| Growth::of(&r.to_vec()),
+            );
+            $rep.measure(
+                ($name, "incident", "parallel_batch"),
+                n,
+                || pb.par_incident_mask(&lb),
+                |_| None,
+            );
+        }
+    }};
+}
+
+fn main() {
+    let cfg = Config::from_args();
+    let w = Workload::new(&cfg);
+    let mut rep = Report {
+        cfg,
+        rows: Vec::new(),
+    };
+    let rep = &mut rep;
+    geometry!(rep, &w, "Pg", PgPoint, PgLine, PgPointBatch, PgLineBatch);
+    geometry!(
+        rep,
+        &w,
+        "Hyp",
+        HypPoint,
+        HypLine,
+        HypPointBatch,
+        HypLineBatch
+    );
+    geometry!(
+        rep,
+        &w,
+        "Ell",
+        EllPoint,
+        EllLine,
+        EllPointBatch,
+        EllLineBatch
+    );
+    geometry!(
+        rep,
+        &w,
+        "MyCK",
+        MyCKPoint,
+        MyCKLine,
+        MyCKPointBatch,
+        MyCKLineBatch
+    );
+    geometry!(
+        rep,
+        &w,
+        "Persp",
+        PerspPoint,
+        PerspLine,
+        PerspPointBatch,
+        PerspLineBatch
+    );
+    geometry!(
+        rep,
+        &w,
+        "Euclid",
+        EuclidPoint,
+        EuclidLine,
+        EuclidPointBatch,
+        EuclidLineBatch
+    );
+    cayley_klein::<HypPoint, HypLine>(rep, "Hyp", &w, HypPoint::new);
+    cayley_klein::<EllPoint, EllLine>(rep, "Ell", &w, EllPoint::new);
+    cayley_klein::<MyCKPoint, MyCKLine>(rep, "MyCK", &w, MyCKPoint::new);
+    cayley_klein::<PerspPoint, PerspLine>(rep, "Persp", &w, PerspPoint::new);
+    cayley_klein::<EuclidPoint, EuclidLine>(rep, "Euclid", &w, EuclidPoint::new);
+    print!("{}", rep.to_json());
+}
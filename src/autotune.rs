@@ -0,0 +1,392 @@
+// Integer width selection for batch kernels
+//
+// Coordinates are stored as i128, but most inputs are far narrower.
+// `circ_width` scans inputs for the largest magnitude (an OR over the
+// absolute values, which vectorizes) and bounds the magnitude of their
+// joins from it: a cross product of `b`-bit inputs needs `2b + 1` bits, and
+// `circ_levels` chains this bound to tell how many successive joins and
+// meets a width can afford (`plucker_width`/`plucker_levels` and
+// `incident_width` do the same for Plucker combinations and incidence
+// tests). Every width query returns `None` once even i128 would overflow. `narrow_batch` then copies the inputs once into
+// `pg_batch` columns of the chosen width, where the batch kernels run.
+// There is deliberately no per-call dispatch from i128 rows: converting to
+// narrow columns and back costs more than an i128 cross product of small
+// values, so the saving only comes from keeping the data narrow across
+// several kernels. The widths built are counted as `metrics::Op::KernelI32`
+// etc.
+
+use crate::metrics::{self, Op};
+use crate::pg_batch::PgPointBatchT;
+use crate::pg_object::Scalar;
+
+/// Integer width of a kernel
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord, Hash)]
+pub enum Width {
+    I32,
+    I64,
+    I128,
+}
+
+impl Width {
+    /// Magnitude bits: values of bit length up to this fit
+    #[inline]
+    pub const fn bits(self) -> u32 {
+        match self {
+            Width::I32 => 31,
+            Width::I64 => 63,
+            Width::I128 => 127,
+        }
+    }
+
+    /// Narrowest width holding values of bit length `bits`, `None` if even
+    /// i128 is too narrow
+    #[inline]
+    pub const fn for_bits(bits: u32) -> Option<Width> {
+        if bits <= 31 {
+            Some(Width::I32)
+        } else if bits <= 63 {
+            Some(Width::I64)
+        } else if bits <= 127 {
+            Some(Width::I128)
+        } else {
+            None
+        }
+    }
+
+    #[inline]
+    fn count(self) {
+        metrics::count(match self {
+            Width::I32 => Op::KernelI32,
+            Width::I64 => Op::KernelI64,
+            Width::I128 => Op::KernelI128,
+        });
+    }
+}
+
+/**
+Largest bit length of the magnitude of any coordinate
+
+Examples:
+
+```rust
+use projgeom_rs::autotune::max_bits;
+use projgeom_rs::PgPoint;
+assert_eq!(max_bits(&[PgPoint::new([1, -8, 3]), PgPoint::new([0, 5, 2])]), 4);
+assert_eq!(max_bits(&[PgPoint::new([0; 3])]), 0);
+```
+*/
+#[inline]
+pub fn max_bits<C: AsRef<[i128; 3]>>(coords: &[C]) -> u32 {
+    let acc = coords.iter().fold(0u128, |acc, c| {
+        let [x, y, z] = c.as_ref();
+        acc | x.unsigned_abs() | y.unsigned_abs() | z.unsigned_abs()
+    });
+    128 - acc.leading_zeros()
+}
+
+/// Bit length bound of a cross product of `bits`-bit coordinates
+#[inline]
+pub const fn circ_bits(bits: u32) -> u32 {
+    2 * bits + 1
+}
+
+/**
+How many successive `circ` levels (a join, then a meet of such joins, ...)
+of `bits`-bit inputs stay within `width`
+
+Examples:
+
+```rust
+use projgeom_rs::autotune::{circ_levels, Width};
+assert_eq!(circ_levels(7, Width::I32), 2); // 15 bits, then 31
+assert_eq!(circ_levels(7, Width::I64), 3);
+assert_eq!(circ_levels(20, Width::I128), 2);
+```
+*/
+pub const fn circ_levels(bits: u32, width: Width) -> u32 {
+    let (mut bits, mut levels) = (bits, 0);
+    loop {
+        bits = circ_bits(bits);
+        if bits > width.bits() {
+            return levels;
+        }
+        levels += 1;
+    }
+}
+
+/**
+Width the joins of `ps[i]` and `qs[i]` need, `None` if even i128 is too
+narrow
+
+Examples:
+
+```rust
+use projgeom_rs::autotune::{circ_width, Width};
+use projgeom_rs::PgPoint;
+let ps = [PgPoint::new([1 << 20, 3, 2])];
+assert_eq!(circ_width(&ps, &ps), Some(Width::I64));
+let wide = [PgPoint::new([1 << 64, 3, 2])];
+assert_eq!(circ_width(&wide, &ps), None);
+```
+*/
+#[inline]
+pub fn circ_width<P: AsRef<[i128; 3]>>(ps: &[P], qs: &[P]) -> Option<Width> {
+    let bits = max_bits(ps).max(max_bits(qs));
+    Width::for_bits(circ_bits(bits))
+}
+
+/// Bit length bound of `ld p + mu q` for `scalar_bits`-bit `ld`, `mu` and
+/// `bits`-bit `p`, `q`
+#[inline]
+pub const fn plucker_bits(scalar_bits: u32, bits: u32) -> u32 {
+    scalar_bits + bits + 1
+}
+
+/**
+How many successive `plucker` levels (a combination, then a combination
+of such results, ...) with `scalar_bits`-bit coefficients of `bits`-bit
+inputs stay within `width`
+
+Examples:
+
+```rust
+use projgeom_rs::autotune::{plucker_levels, Width};
+assert_eq!(plucker_levels(10, 8, Width::I32), 2); // 19 bits, then 30
+assert_eq!(plucker_levels(10, 8, Width::I64), 5);
+```
+*/
+pub const fn plucker_levels(bits: u32, scalar_bits: u32, width: Width) -> u32 {
+    let (mut bits, mut levels) = (bits, 0);
+    loop {
+        bits = plucker_bits(scalar_bits, bits);
+        if bits > width.bits() {
+            return levels;
+        }
+        levels += 1;
+    }
+}
+
+#[inline]
+fn scalar_bits(vs: &[i128]) -> u32 {
+    128 - vs
+        .iter()
+        .fold(0u128, |acc, v| acc | v.unsigned_abs())
+        .leading_zeros()
+}
+
+/// Width the combinations `ps[i].plucker(&ld[i], &qs[i], &mu[i])` need,
+/// `None` if even i128 is too narrow
+#[inline]
+pub fn plucker_width<P: AsRef<[i128; 3]>>(
+    ld: &[i128],
+    ps: &[P],
+    mu: &[i128],
+    qs: &[P],
+) -> Option<Width> {
+    let p = plucker_bits(scalar_bits(ld), max_bits(ps));
+    let q = plucker_bits(scalar_bits(mu), max_bits(qs));
+    Width::for_bits(p.max(q))
+}
+
+/**
+Bit length bound of a dot product of `point_bits`-bit points with
+`line_bits`-bit lines: three products and two additions
+
+Examples:
+
+```rust
+use projgeom_rs::autotune::{circ_bits, dot_bits};
+assert_eq!(dot_bits(10, circ_bits(10)), 33); // points on their joins: 3b + 3
+```
+*/
+#[inline]
+pub const fn dot_bits(point_bits: u32, line_bits: u32) -> u32 {
+    point_bits + line_bits + 2
+}
+
+/// Width the incidence tests of `ps[i]` and `ls[i]` need, `None` if even
+/// i128 is too narrow
+#[inline]
+pub fn incident_width<P, L>(ps: &[P], ls: &[L]) -> Option<Width>
+where
+    P: AsRef<[i128; 3]>,
+    L: AsRef<[i128; 3]>,
+{
+    Width::for_bits(dot_bits(max_bits(ps), max_bits(ls)))
+}
+
+/// The coordinate types a narrowed batch can hold
+pub trait Lane: Scalar + TryFrom<i128> + Into<i128> {
+    const WIDTH: Width;
+}
+
+impl Lane for i32 {
+    const WIDTH: Width = Width::I32;
+}
+
+impl Lane for i64 {
+    const WIDTH: Width = Width::I64;
+}
+
+impl Lane for i128 {
+    const WIDTH: Width = Width::I128;
+}
+
+/**
+Columns of `cs` in the lane type `T`, or `None` if a coordinate does not fit
+
+The check is fused into the copy, so the coordinates are read once. The
+result runs the `pg_batch` kernels (`circ_many`, `plucker_many`,
+`incident_mask`, ...) in `T`; the narrowing only pays off when it is done
+once for several such kernels, since a single i128 cross product of small
+values costs less than the copy. `circ_levels` and `plucker_levels` tell
+how many levels of joins and meets or of Plucker combinations stay exact
+in `T`, and `incident_width` which width the incidence tests need.
+
+Examples:
+
+```rust
+use projgeom_rs::autotune::{narrow_batch, widen_many};
+use projgeom_rs::{PgLine, PgPoint, ProjPlanePrim};
+let ps = [PgPoint::new([1, 3, 2]), PgPoint::new([7, -1, 4])];
+let qs = [PgPoint::new([-2, 1, -1]), PgPoint::new([1, 1, 1])];
+let (pb, qb) = (narrow_batch::<i32, _>(&ps).unwrap(), narrow_batch::<i32, _>(&qs).unwrap());
+let lb = pb.circ_many(&qb);
+let ls: Vec<PgLine> = widen_many([&lb.x, &lb.y, &lb.z]);
+assert_eq!(ls[1], ps[1].circ(&qs[1]));
+assert!(narrow_batch::<i32, _>(&[PgPoint::new([1 << 40, 1, 1])]).is_none());
+```
+*/
+pub fn narrow_batch<T: Lane, C: AsRef<[i128; 3]>>(cs: &[C]) -> Option<PgPointBatchT<T>> {
+    let mut res = PgPointBatchT::with_capacity(cs.len());
+    for c in cs {
+        let [x, y, z] = c.as_ref().map(T::try_from);
+        res.x.push(x.ok()?);
+        res.y.push(y.ok()?);
+        res.z.push(z.ok()?);
+    }
+    T::WIDTH.count();
+    Some(res)
+}
+
+/// Rows of the columns `cols` back in i128 (see `narrow_batch`)
+pub fn widen_many<T: Lane, O: From<[i128; 3]>>(cols: [&[T]; 3]) -> Vec<O> {
+    let [x, y, z] = cols;
+    let (y, z) = (&y[..x.len()], &z[..x.len()]);
+    (0..x.len())
+        .map(|i| O::from([x[i].into(), y[i].into(), z[i].into()]))
+        .collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_object::{HypLine, HypPoint};
+    use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+
+    /// Coordinates filling `bits` bits
+    fn points(bits: u32) -> Vec<HypPoint> {
+        let m = (1i128 << bits) - 1;
+        let c = |i: i128, k: i128| ((i * 7919 + k) * 2_654_435_761) & m;
+        (0..100)
+            .map(|i| HypPoint::new([c(i, 1) | (1 << (bits - 1)), -c(i, 2), c(i, 3) + 1]))
+            .collect()
+    }
+
+    /// Runs `$f::<T>` for the lane of `$width`
+    macro_rules! in_lane {
+        ($width:expr, $f:ident($($arg:expr),*)) => {
+            match $width {
+                Width::I32 => $f::<i32>($($arg),*),
+                Width::I64 => $f::<i64>($($arg),*),
+                Width::I128 => $f::<i128>($($arg),*),
+            }
+        };
+    }
+
+    fn check_incident<T: Lane>(ps: &[HypPoint], ls: &[HypLine]) {
+        let pb = narrow_batch::<T, _>(ps).unwrap();
+        let narrow = narrow_batch::<T, _>(ls).unwrap();
+        let lb = crate::pg_batch::PgLineBatchT {
+            x: narrow.x,
+            y: narrow.y,
+            z: narrow.z,
+        };
+        let expected: Vec<bool> = ps.iter().zip(ls).map(|(p, l)| p.incident(l)).collect();
+        assert_eq!(pb.incident_mask(&lb), expected);
+    }
+
+    fn check_narrow<T: Lane>(ps: &[HypPoint], qs: &[HypPoint]) {
+        let (pb, qb) = (
+            narrow_batch::<T, _>(ps).unwrap(),
+            narrow_batch::<T, _>(qs).unwrap(),
+        );
+        let lb = pb.circ_many(&qb);
+        let ls: Vec<HypLine> = widen_many([&lb.x, &lb.y, &lb.z]);
+        for i in 0..ps.len() {
+            assert_eq!(ls[i].coord, ps[i].circ(&qs[i]).coord);
+        }
+        let ld: Vec<T> = (0..100)
+            .map(|i| T::try_from(i - 50).ok().unwrap())
+            .collect();
+        let mu: Vec<T> = (0..100)
+            .map(|i| T::try_from(3 * i + 1).ok().unwrap())
+            .collect();
+        let rb = pb.plucker_many(&ld, &qb, &mu);
+        let rs: Vec<HypPoint> = widen_many([&rb.x, &rb.y, &rb.z]);
+        for i in 0..ps.len() {
+            let (l, m) = (ld[i].into(), mu[i].into());
+            assert_eq!(rs[i].coord, ps[i].plucker(&l, &qs[i], &m).coord);
+        }
+    }
+
+    #[test]
+    fn test_widths_agree_with_i128() {
+        for (bits, width, dot) in [
+            (10, Width::I32, Width::I64),
+            (20, Width::I64, Width::I64),
+            (40, Width::I128, Width::I128),
+        ] {
+            let ps = points(bits);
+            let qs: Vec<HypPoint> = ps.iter().rev().copied().collect();
+            assert_eq!(circ_width(&ps, &qs), Some(width));
+            let ld: Vec<i128> = (0..100).map(|i| i - 50).collect();
+            let mu: Vec<i128> = (0..100).map(|i| 3 * i + 1).collect();
+            assert!(plucker_width(&ld, &ps, &mu, &qs) <= Some(width)); // small `ld`, `mu`
+            in_lane!(width, check_narrow(&ps, &qs));
+            // points on their joins, and off the joins of the next pair
+            let ls: Vec<HypLine> = (0..ps.len())
+                .map(|i| match i % 2 {
+                    0 => ps[i].circ(&qs[i]),
+                    _ => qs[i].circ(&qs[(i + 1) % qs.len()]),
+                })
+                .collect();
+            assert_eq!(incident_width(&ps, &ls), Some(dot)); // 3b + 3 bits
+            in_lane!(dot, check_incident(&ps, &ls));
+        }
+        assert!(narrow_batch::<i32, _>(&points(31)).is_some());
+        assert!(narrow_batch::<i32, _>(&points(32)).is_none());
+        assert!(narrow_batch::<i64, _>(&points(32)).is_some());
+        assert_eq!(max_bits(&[HypPoint::new([i128::MIN + 1, 0, 0])]), 127);
+        let (wide, min) = (points(63), [HypPoint::new([i128::MIN, 1, 1])]);
+        assert_eq!(circ_width(&wide, &wide), Some(Width::I128));
+        assert_eq!(circ_width(&points(64), &wide), None);
+        assert_eq!(circ_width(&min, &min), None);
+        assert_eq!(incident_width(&wide, &wide), None);
+        assert_eq!(plucker_width(&[1 << 64], &min, &[1], &min), None);
+        assert_eq!(Width::for_bits(128), None);
+    }
+
+    #[cfg(feature = "metrics")]
+    #[test]
+    fn test_reports_width() {
+        let _guard = metrics::test_guard();
+        let before = metrics::local_snapshot();
+        let _ = narrow_batch::<i32, _>(&points(8));
+        let _ = narrow_batch::<i32, _>(&points(40));
+        let _ = narrow_batch::<i128, _>(&points(40));
+        let d = metrics::local_snapshot();
+        assert_eq!(d.count(Op::KernelI32) - before.count(Op::KernelI32), 1);
+        assert_eq!(d.count(Op::KernelI128) - before.count(Op::KernelI128), 1);
+    }
+}
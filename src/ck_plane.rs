@@ -1,11 +1,206 @@
-use crate::pg_plane::{coincident, involution, tri_dual};
+use crate::fractions::{BinaryGcd, Fraction};
+use crate::metrics::{self, Op};
+use crate::pg_object::{cross, Scalar};
+use crate::pg_plane::{involution, tri_dual_unchecked, try_tri_dual};
 use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+use core::ops::DivAssign;
+use num_integer::Integer;
 
 pub trait CKPlanePrim<L>: ProjPlanePrim<L> {
     // type Dual: ProjPlanePrim;
     fn perp(&self) -> L;
+
+    /// See `try_orthocenter`; overridden where the coordinates are known
+    /// (see `impl_fused_ck`)
+    #[inline]
+    fn try_orthocenter(tri: &[Self; 3]) -> Option<Self>
+    where
+        Self: Sized,
+        L: CKPlanePrim<Self>,
+    {
+        let [a1, a2, a3] = tri;
+        let l1 = a2.circ(a3);
+        if l1.incident(a1) {
+            return None; // coincident(a1, a2, a3)
+        }
+        let t1 = altitude(a1, &l1);
+        let t2 = altitude(a2, &a3.circ(a1));
+        Some(t1.circ(&t2))
+    }
+
+    /// See `orthocenter_unchecked`
+    #[inline]
+    fn orthocenter_unchecked(tri: &[Self; 3]) -> Self
+    where
+        Self: Sized,
+        L: CKPlanePrim<Self>,
+    {
+        let [a1, a2, a3] = tri;
+        let l1 = a2.circ(a3);
+        debug_assert!(!l1.incident(a1)); // !coincident(a1, a2, a3)
+        let t1 = altitude(a1, &l1);
+        let t2 = altitude(a2, &a3.circ(a1));
+        t1.circ(&t2)
+    }
+
+    /// See `try_tri_altitude`
+    #[inline]
+    fn try_tri_altitude(tri: &[Self; 3]) -> Option<[L; 3]>
+    where
+        Self: Sized,
+        L: CKPlanePrim<Self>,
+    {
+        try_tri_dual(tri).map(|sides| altitudes(tri, &sides))
+    }
+
+    /// See `tri_altitude_unchecked`
+    #[inline]
+    fn tri_altitude_unchecked(tri: &[Self; 3]) -> [L; 3]
+    where
+        Self: Sized,
+        L: CKPlanePrim<Self>,
+    {
+        altitudes(tri, &tri_dual_unchecked(tri))
+    }
 }
 
+/**
+Orthocenter of the triangle `tri` on coordinates, `None` if it is degenerate
+
+`pole` maps a side to its pole (the `perp` of the dual type). This is the
+construction of `try_orthocenter` without the intermediate objects and
+with one metrics update for its five joins and meets.
+
+The construction has total degree 6 in the vertices, and its coordinates
+have no common polynomial factor: neither `det(a1, a2, a3)` nor any
+`l_i^T M l_j` divides them. So no lower-degree closed form exists, and
+the symmetric form `q12 q13 a1 + q12 q23 a2 + q13 q23 a3` (with
+`qij = l_i^T M l_j`) is that determinant times this one and costs more
+multiplies.
+
+Examples:
+
+```rust
+use projgeom_rs::ck_plane::try_orthocenter_coord;
+let perp = |l: &[i64; 3]| [l[0], l[1], -l[2]];
+let o = try_orthocenter_coord([&[1, 0, 1], &[0, 1, 1], &[0, 0, 1]], perp);
+assert_eq!(o, Some([0, 0, 1]));
+assert_eq!(try_orthocenter_coord([&[1, 0, 1], &[2, 0, 1], &[3, 0, 1]], perp), None);
+```
+*/
+#[inline(always)]
+pub fn try_orthocenter_coord<T: Scalar>(
+    tri: [&[T; 3]; 3],
+    pole: impl Fn(&[T; 3]) -> [T; 3],
+) -> Option<[T; 3]> {
+    let [a1, a2, a3] = tri;
+    let l1 = cross(a2, a3);
+    metrics::count(Op::Incident);
+    if T::dot_is_zero(&l1, a1) {
+        metrics::count(Op::Circ);
+        return None; // coincident(a1, a2, a3)
+    }
+    Some(orthocenter_from_side(tri, &l1, pole))
+}
+
+/// `try_orthocenter_coord` of a triangle known to be non-degenerate
+#[inline(always)]
+pub fn orthocenter_coord<T: Scalar>(tri: [&[T; 3]; 3], pole: impl Fn(&[T; 3]) -> [T; 3]) -> [T; 3] {
+    let [a1, a2, a3] = tri;
+    let l1 = cross(a2, a3);
+    debug_assert!(!T::dot_is_zero(&l1, a1)); // !coincident(a1, a2, a3)
+    orthocenter_from_side(tri, &l1, pole)
+}
+
+#[inline(always)]
+fn orthocenter_from_side<T: Scalar>(
+    tri: [&[T; 3]; 3],
+    l1: &[T; 3],
+    pole: impl Fn(&[T; 3]) -> [T; 3],
+) -> [T; 3] {
+    let [a1, a2, a3] = tri;
+    let t1 = cross(&pole(l1), a1);
+    let t2 = cross(&pole(&cross(a3, a1)), a2);
+    let res = cross(&t1, &t2);
+    metrics::count_n(Op::Circ, 5);
+    metrics::record(&res);
+    res
+}
+
+/// Altitudes of the triangle `tri` on coordinates, as `tri_altitude` orders them
+#[inline(always)]
+pub fn tri_altitude_coord<T: Scalar>(
+    tri: [&[T; 3]; 3],
+    sides: [[T; 3]; 3],
+    pole: impl Fn(&[T; 3]) -> [T; 3],
+) -> [[T; 3]; 3] {
+    let res = [0, 1, 2].map(|i| cross(&pole(&sides[i]), tri[i]));
+    metrics::count_n(Op::Circ, 6);
+    res.iter().for_each(metrics::record);
+    res
+}
+
+/// Sides of the triangle `tri` on coordinates, `None` if it is degenerate
+#[inline(always)]
+pub fn try_tri_dual_coord<T: Scalar>(tri: [&[T; 3]; 3]) -> Option<[[T; 3]; 3]> {
+    let [a1, a2, a3] = tri;
+    let l1 = cross(a2, a3);
+    metrics::count(Op::Incident);
+    if T::dot_is_zero(&l1, a1) {
+        return None; // coincident(a1, a2, a3)
+    }
+    Some([l1, cross(a1, a3), cross(a1, a2)])
+}
+
+/// Overrides of the `CKPlanePrim` triangle constructions by the coordinate
+/// kernels above, for a type with `coord` and `new` whose dual is `$line`
+/// (over the scalar `T`)
+macro_rules! impl_fused_ck {
+    ($line:ty) => {
+        #[inline]
+        fn try_orthocenter(tri: &[Self; 3]) -> Option<Self> {
+            let [a1, a2, a3] = tri;
+            let pole = |l: &[T; 3]| <$line>::new(*l).perp().coord;
+            $crate::ck_plane::try_orthocenter_coord([&a1.coord, &a2.coord, &a3.coord], pole)
+                .map(Self::new)
+        }
+
+        #[inline]
+        fn orthocenter_unchecked(tri: &[Self; 3]) -> Self {
+            let [a1, a2, a3] = tri;
+            let pole = |l: &[T; 3]| <$line>::new(*l).perp().coord;
+            Self::new($crate::ck_plane::orthocenter_coord(
+                [&a1.coord, &a2.coord, &a3.coord],
+                pole,
+            ))
+        }
+
+        #[inline]
+        fn try_tri_altitude(tri: &[Self; 3]) -> Option<[$line; 3]> {
+            let [a1, a2, a3] = tri;
+            let coords = [&a1.coord, &a2.coord, &a3.coord];
+            let pole = |l: &[T; 3]| <$line>::new(*l).perp().coord;
+            let sides = $crate::ck_plane::try_tri_dual_coord(coords)?;
+            Some($crate::ck_plane::tri_altitude_coord(coords, sides, pole).map(<$line>::new))
+        }
+
+        #[inline]
+        fn tri_altitude_unchecked(tri: &[Self; 3]) -> [$line; 3] {
+            let [a1, a2, a3] = tri;
+            let coords = [&a1.coord, &a2.coord, &a3.coord];
+            let pole = |l: &[T; 3]| <$line>::new(*l).perp().coord;
+            let sides = [
+                $crate::pg_object::cross(&a2.coord, &a3.coord),
+                $crate::pg_object::cross(&a1.coord, &a3.coord),
+                $crate::pg_object::cross(&a1.coord, &a2.coord),
+            ];
+            debug_assert!(!T::dot_is_zero(&sides[0], &a1.coord)); // !coincident(a1, a2, a3)
+            $crate::ck_plane::tri_altitude_coord(coords, sides, pole).map(<$line>::new)
+        }
+    };
+}
+pub(crate) use impl_fused_ck;
+
 #[allow(dead_code)]
 #[inline]
 pub fn is_perpendicular<P, L>(m1: &L, m2: &L) -> bool
@@ -33,11 +228,39 @@ where
     P: CKPlanePrim<L>,
     L: CKPlanePrim<P>,
 {
-    let [a1, a2, a3] = tri;
-    assert!(!coincident(a1, a2, a3));
-    let t1 = altitude(a1, &a2.circ(a3));
-    let t2 = altitude(a2, &a3.circ(a1));
-    t1.circ(&t2)
+    try_orthocenter(tri).expect("orthocenter: degenerate triangle")
+}
+
+/**
+Orthocenter of a triangle, or `None` if its vertices are collinear
+
+Examples:
+
+```rust
+use projgeom_rs::{try_orthocenter, HypPoint};
+let tri = [[13, 23, 32], [44, -34, 2], [-2, 12, 23]].map(HypPoint::new);
+assert!(try_orthocenter(&tri).is_some());
+let flat = [[0, 0, 1], [1, 1, 1], [2, 2, 1]].map(HypPoint::new);
+assert!(try_orthocenter(&flat).is_none());
+```
+*/
+#[inline]
+pub fn try_orthocenter<P, L>(tri: &[P; 3]) -> Option<P>
+where
+    P: CKPlanePrim<L>,
+    L: CKPlanePrim<P>,
+{
+    P::try_orthocenter(tri)
+}
+
+/// `orthocenter` of a triangle known to be non-degenerate (checked in debug builds only)
+#[inline]
+pub fn orthocenter_unchecked<P, L>(tri: &[P; 3]) -> P
+where
+    P: CKPlanePrim<L>,
+    L: CKPlanePrim<P>,
+{
+    P::orthocenter_unchecked(tri)
 }
 
 #[allow(dead_code)]
@@ -47,24 +270,187 @@ where
     P: CKPlanePrim<L>,
     L: CKPlanePrim<P>,
 {
-    let [l1, l2, l3] = tri_dual(tri);
+    try_tri_altitude(tri).expect("tri_altitude: degenerate triangle")
+}
+
+/// Altitudes of a triangle, or `None` if its vertices are collinear
+#[inline]
+pub fn try_tri_altitude<P, L>(tri: &[P; 3]) -> Option<[L; 3]>
+where
+    P: CKPlanePrim<L>,
+    L: CKPlanePrim<P>,
+{
+    P::try_tri_altitude(tri)
+}
+
+/// `tri_altitude` of a triangle known to be non-degenerate (checked in debug builds only)
+#[inline]
+pub fn tri_altitude_unchecked<P, L>(tri: &[P; 3]) -> [L; 3]
+where
+    P: CKPlanePrim<L>,
+    L: CKPlanePrim<P>,
+{
+    P::tri_altitude_unchecked(tri)
+}
+
+#[inline]
+fn altitudes<P, L>(tri: &[P; 3], sides: &[L; 3]) -> [L; 3]
+where
+    P: CKPlanePrim<L>,
+    L: CKPlanePrim<P>,
+{
     let [a1, a2, a3] = tri;
-    assert!(!coincident(a1, a2, a3));
-    let t1 = altitude(a1, &l1);
-    let t2 = altitude(a2, &l2);
-    let t3 = altitude(a3, &l3);
+    let [l1, l2, l3] = sides;
+    let t1 = altitude(a1, l1);
+    let t2 = altitude(a2, l2);
+    let t3 = altitude(a3, l3);
     [t1, t2, t3]
 }
 
-pub trait CKPlane<L, V: Default + Eq>: ProjPlane<L, V> + CKPlanePrim<L> {}
+pub trait CKPlane<L, V: Default + PartialEq>: ProjPlane<L, V> + CKPlanePrim<L> {}
 
 #[allow(dead_code)]
 #[inline]
 pub fn reflect<P, L, V>(mirror: &L, p: &P) -> P
 where
-    V: Default + Eq,
+    V: Default + PartialEq,
     P: CKPlane<L, V>,
     L: CKPlane<P, V>,
 {
     involution(&mirror.perp(), mirror, p)
 }
+
+/// `a . b^perp`, the bilinear form of the absolute
+#[inline]
+fn omega<P, L, V>(a: &P, b_perp: &L) -> V
+where
+    V: Default + PartialEq,
+    P: CKPlane<L, V>,
+{
+    a.dot(b_perp)
+}
+
+/**
+Quadrance between two points as a ratio `(num, den)`, without dividing
+
+`q(a1, a2) = 1 - w12^2 / (w11 w22)` with `wij = ai . aj^perp`. The
+degenerate absolutes (`EuclidPoint`, `PerspPoint`) give `(0, _)` for every
+pair and are not measured this way. Applied to lines, this is the spread.
+
+Examples:
+
+```rust
+use projgeom_rs::{quadrance_ratio, EllPoint};
+let (a1, a2) = (EllPoint::new([1, 0, 0]), EllPoint::new([1, 1, 0]));
+assert_eq!(quadrance_ratio(&a1, &a2), (1, 2));
+```
+*/
+#[inline]
+pub fn quadrance_ratio<P, L, V>(a1: &P, a2: &P) -> (V, V)
+where
+    V: Scalar,
+    P: CKPlane<L, V>,
+    L: CKPlane<P, V>,
+{
+    let (p1, p2) = (a1.perp(), a2.perp());
+    let (w11, w22, w12) = (omega(a1, &p1), omega(a2, &p2), omega(a1, &p2));
+    let den = w11 * w22;
+    (den - w12 * w12, den)
+}
+
+/// Spread between two lines as a ratio `(num, den)` (see `quadrance_ratio`)
+#[inline]
+pub fn spread_ratio<P, L, V>(l1: &L, l2: &L) -> (V, V)
+where
+    V: Scalar,
+    P: CKPlane<L, V>,
+    L: CKPlane<P, V>,
+{
+    quadrance_ratio(l1, l2)
+}
+
+/**
+Quadrance between two points, reduced
+
+Examples:
+
+```rust
+use projgeom_rs::{quadrance, Fraction, HypPoint};
+let (a1, a2) = (HypPoint::new([0, 0, 1]), HypPoint::new([1, 0, 2]));
+assert_eq!(quadrance(&a1, &a2), Fraction::new(-1, 3));
+```
+*/
+#[inline]
+pub fn quadrance<P, L, T>(a1: &P, a2: &P) -> Fraction<T>
+where
+    T: Scalar + Integer + DivAssign + BinaryGcd,
+    P: CKPlane<L, T>,
+    L: CKPlane<P, T>,
+{
+    let (num, den) = quadrance_ratio(a1, a2);
+    Fraction::new(num, den)
+}
+
+/// Spread between two lines, reduced
+#[inline]
+pub fn spread<P, L, T>(l1: &L, l2: &L) -> Fraction<T>
+where
+    T: Scalar + Integer + DivAssign + BinaryGcd,
+    P: CKPlane<L, T>,
+    L: CKPlane<P, T>,
+{
+    quadrance(l1, l2)
+}
+
+/// Element-wise `quadrance_ratio(&ps[i], &qs[i])` (`spread_ratio` for lines)
+pub fn quadrance_many<P, L, V>(ps: &[P], qs: &[P]) -> Vec<(V, V)>
+where
+    V: Scalar,
+    P: CKPlane<L, V>,
+    L: CKPlane<P, V>,
+{
+    assert_eq!(ps.len(), qs.len());
+    ps.iter()
+        .zip(qs)
+        .map(|(p, q)| quadrance_ratio(p, q))
+        .collect()
+}
+
+/**
+Quadrance between every pair of `ps`, row-major: entry `i * n + j` is
+`quadrance_ratio(&ps[i], &ps[j])`
+
+Each `perp` and each `wii` is computed once; a pair costs one `dot` and
+three multiplies.
+
+Examples:
+
+```rust
+use projgeom_rs::{quadrance_matrix, quadrance_ratio, HypPoint};
+let ps = [[0, 0, 1], [1, 0, 2], [0, 1, 3]].map(HypPoint::new);
+let qs = quadrance_matrix(&ps);
+assert_eq!(qs[1 * 3 + 2], quadrance_ratio(&ps[1], &ps[2]));
+assert_eq!(qs[0].0, 0);
+```
+*/
+pub fn quadrance_matrix<P, L, V>(ps: &[P]) -> Vec<(V, V)>
+where
+    V: Scalar,
+    P: CKPlane<L, V>,
+    L: CKPlane<P, V>,
+{
+    let perps: Vec<L> = ps.iter().map(|p| p.perp()).collect();
+    let ws: Vec<V> = ps.iter().zip(&perps).map(|(p, l)| omega(p, l)).collect();
+    let n = ps.len();
+    let mut res = vec![(V::ZERO, V::ZERO); n * n];
+    for i in 0..n {
+        res[i * n + i] = (V::ZERO, ws[i] * ws[i]);
+        for j in (i + 1)..n {
+            let w = omega(&ps[i], &perps[j]);
+            let den = ws[i] * ws[j];
+            res[i * n + j] = (den - w * w, den);
+            res[j * n + i] = res[i * n + j];
+        }
+    }
+    res
+}
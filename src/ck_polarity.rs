@@ -0,0 +1,203 @@
+// Cayley-Klein planes defined by a polarity matrix
+//
+// A new metric is a marker type implementing `Polarity`: `POLAR` maps a
+// point to its polar line and `POLE` maps a line back to its pole (the
+// adjugate of `POLAR`, up to scale). Both are associated consts, so after
+// inlining `perp` multiplies only by the nonzero entries: zeros vanish,
+// entries of +-1 become a copy or a negation, and a diagonal matrix costs
+// exactly what a hand-written `perp` does. Degenerate (Euclidean or
+// perspective) absolutes are not linear maps and keep their own types.
+
+use crate::ck_plane::{impl_fused_ck, CKPlane, CKPlanePrim};
+use crate::pg_object::{impl_coord_object, impl_line_for_point, Scalar};
+use core::fmt::Debug;
+use core::marker::PhantomData;
+
+pub trait Polarity: Copy + Debug {
+    /// Point to polar line
+    const POLAR: [[i64; 3]; 3];
+    /// Line to pole, proportional to the adjugate of `POLAR`
+    const POLE: [[i64; 3]; 3];
+}
+
+/// Integer constant `c` as a scalar; folds to a literal for constant `c`
+#[inline(always)]
+fn small<T: Scalar>(c: i64) -> T {
+    let two = T::ONE + T::ONE;
+    match c {
+        2 => return two,
+        -2 => return -two,
+        _ => {}
+    }
+    let (mut res, mut base, mut n) = (T::ZERO, T::ONE, c.unsigned_abs());
+    while n != 0 {
+        if n & 1 == 1 {
+            res = res + base;
+        }
+        base = base + base;
+        n >>= 1;
+    }
+    if c < 0 {
+        -res
+    } else {
+        res
+    }
+}
+
+#[inline(always)]
+fn add_term<T: Scalar>(acc: Option<T>, c: i64, x: T) -> Option<T> {
+    let term = match c {
+        0 => return acc,
+        1 => x,
+        -1 => -x,
+        _ => small::<T>(c) * x,
+    };
+    Some(match acc {
+        Some(a) => a + term,
+        None => term,
+    })
+}
+
+#[inline(always)]
+fn row<T: Scalar>(r: [i64; 3], x: &[T; 3]) -> T {
+    let acc = add_term(None, r[0], x[0]);
+    let acc = add_term(acc, r[1], x[1]);
+    add_term(acc, r[2], x[2]).unwrap_or(T::ZERO)
+}
+
+/**
+Matrix-vector product with a constant integer matrix
+
+Examples:
+
+```rust
+use projgeom_rs::ck_polarity::apply;
+assert_eq!(apply([[1, 0, 0], [0, 1, 0], [0, 0, -1]], &[3, 4, 5]), [3, 4, -5]);
+assert_eq!(apply([[2, 1, 0], [1, 2, 0], [0, 0, -1]], &[3, 4, 5]), [10, 11, -5]);
+```
+*/
+#[inline(always)]
+pub fn apply<T: Scalar>(m: [[i64; 3]; 3], x: &[T; 3]) -> [T; 3] {
+    [row(m[0], x), row(m[1], x), row(m[2], x)]
+}
+
+macro_rules! define_polar_object {
+    (impl $point:ident) => {
+        #[derive(Debug, Clone, Copy)]
+        pub struct $point<G, T> {
+            /// Homogeneous coordinate
+            pub coord: [T; 3],
+            polarity: PhantomData<G>,
+        }
+
+        impl<G, T> $point<G, T> {
+            #[inline]
+            pub const fn new(coord: [T; 3]) -> Self {
+                Self {
+                    coord,
+                    polarity: PhantomData,
+                }
+            }
+        }
+
+        impl_coord_object!([G] $point);
+    };
+}
+
+macro_rules! define_polar_dual {
+    (impl $point:ident, $line:ident, $matrix:ident) => {
+        impl_line_for_point!([G: Polarity] $line, $point);
+
+        impl<G: Polarity, T: Scalar> CKPlanePrim<$line<G, T>> for $point<G, T> {
+            #[inline]
+            fn perp(&self) -> $line<G, T> {
+                $line::new(apply(G::$matrix, &self.coord))
+            }
+
+            impl_fused_ck!($line<G, T>);
+        }
+
+        impl<G: Polarity, T: Scalar> CKPlane<$line<G, T>, T> for $point<G, T> {}
+    };
+}
+
+define_polar_object!(impl PolarPointT);
+define_polar_object!(impl PolarLineT);
+define_polar_dual!(impl PolarPointT, PolarLineT, POLAR);
+define_polar_dual!(impl PolarLineT, PolarPointT, POLE);
+
+pub type PolarPoint<G> = PolarPointT<G, i128>;
+pub type PolarLine<G> = PolarLineT<G, i128>;
+
+/// The absolute of `HypPoint`: x^2 + y^2 - z^2 = 0
+#[derive(Debug, Clone, Copy)]
+pub struct HypPolarity;
+
+impl Polarity for HypPolarity {
+    const POLAR: [[i64; 3]; 3] = [[1, 0, 0], [0, 1, 0], [0, 0, -1]];
+    const POLE: [[i64; 3]; 3] = [[1, 0, 0], [0, 1, 0], [0, 0, -1]];
+}
+
+/// The absolute of `EllPoint`: x^2 + y^2 + z^2 = 0
+#[derive(Debug, Clone, Copy)]
+pub struct EllPolarity;
+
+impl Polarity for EllPolarity {
+    const POLAR: [[i64; 3]; 3] = [[1, 0, 0], [0, 1, 0], [0, 0, 1]];
+    const POLE: [[i64; 3]; 3] = [[1, 0, 0], [0, 1, 0], [0, 0, 1]];
+}
+
+/// The absolute of `MyCKPoint`
+#[derive(Debug, Clone, Copy)]
+pub struct MyCKPolarity;
+
+impl Polarity for MyCKPolarity {
+    const POLAR: [[i64; 3]; 3] = [[-2, 0, 0], [0, 1, 0], [0, 0, -2]];
+    const POLE: [[i64; 3]; 3] = [[-1, 0, 0], [0, 2, 0], [0, 0, -1]];
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ck_plane::{orthocenter, reflect};
+    use crate::pg_object::{HypPoint, MyCKLine, MyCKPoint};
+    use crate::pg_plane::ProjPlanePrim;
+
+    #[derive(Debug, Clone, Copy)]
+    struct Skew;
+
+    impl Polarity for Skew {
+        const POLAR: [[i64; 3]; 3] = [[2, 1, 0], [1, 2, 0], [0, 0, -1]];
+        const POLE: [[i64; 3]; 3] = [[-2, 1, 0], [1, -2, 0], [0, 0, 3]];
+    }
+
+    #[test]
+    fn test_polarity_matches_hand_written() {
+        let coords = [[13, 23, 32], [44, -34, 2], [-2, 12, 23]];
+        let tri = coords.map(PolarPoint::<HypPolarity>::new);
+        assert_eq!(
+            orthocenter(&tri).coord,
+            orthocenter(&coords.map(HypPoint::new)).coord
+        );
+
+        let (m, p) = ([3, -1, 7], [2, 5, 3]);
+        let r = reflect(&PolarLine::<MyCKPolarity>::new(m), &PolarPoint::new(p));
+        assert_eq!(
+            r.coord,
+            reflect(&MyCKLine::new(m), &MyCKPoint::new(p)).coord
+        );
+    }
+
+    #[test]
+    fn test_custom_polarity() {
+        let p = PolarPointT::<Skew, i64>::new([3, 4, 5]);
+        // pole of the polar gives the point back, up to det(POLAR) = -3
+        assert_eq!(p.perp().perp().coord, p.coord.map(|c| -3 * c));
+        let tri = [[13, 23, 32], [44, -34, 2], [-2, 12, 23]].map(PolarPointT::<Skew, i64>::new);
+        let o = orthocenter(&tri);
+        let [a1, a2, a3] = tri;
+        // the altitude through a1 is perpendicular to a2 a3 and passes o
+        let t1 = a2.circ(&a3).perp().circ(&a1);
+        assert!(t1.incident(&o));
+    }
+}
@@ -0,0 +1,666 @@
+// Memoizing construction graph
+//
+// A `Construction` holds the points and lines of a configuration as nodes
+// and remembers every join, meet and perp it has evaluated. Nodes are
+// hash-consed: a result is hashed in its canonical form (see
+// `normalize_coord`) and a projectively equal object already in the graph
+// is reused, so equal objects always have equal ids. Combined with the memo
+// tables this means that a subconstruction shared by several queries (the
+// sides of a triangle used by both `persp` and `tri_dual`, the nine joins
+// of overlapping Pappus configurations, ...) is evaluated once, and that
+// equality and coincidence of nodes reduce to comparing ids.
+//
+// Evaluation is eager; memoization is what removes the repeated work. The
+// `join_many`/`meet_many` batches evaluate only the pairs not yet in the
+// graph; with the `parallel` feature, `par_join_many`/`par_meet_many` do so
+// on the rayon pool.
+
+use crate::ck_plane::CKPlanePrim;
+use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+use core::hash::Hash;
+use std::collections::HashMap;
+
+/// Index of a point node
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub struct PointId(pub usize);
+
+/// Index of a line node
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash, PartialOrd, Ord)]
+pub struct LineId(pub usize);
+
+/// Memo table counters
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct CacheStats {
+    /// Operations answered from a memo table
+    pub hits: u64,
+    /// Operations that were evaluated
+    pub misses: u64,
+}
+
+/// Nodes of one kind, hash-consed by value
+#[derive(Debug, Clone)]
+struct Nodes<O> {
+    objs: Vec<O>,
+    lookup: HashMap<O, usize>,
+}
+
+impl<O> Default for Nodes<O> {
+    fn default() -> Self {
+        Self {
+            objs: Vec::new(),
+            lookup: HashMap::new(),
+        }
+    }
+}
+
+impl<O: Hash + Eq + Clone> Nodes<O> {
+    #[inline]
+    fn intern(&mut self, obj: O) -> usize {
+        if let Some(id) = self.lookup.get(&obj) {
+            return *id;
+        }
+        let id = self.objs.len();
+        self.lookup.insert(obj.clone(), id);
+        self.objs.push(obj);
+        id
+    }
+}
+
+#[derive(Debug, Clone)]
+pub struct Construction<P, L> {
+    points: Nodes<P>,
+    lines: Nodes<L>,
+    joins: HashMap<(usize, usize), usize>,
+    meets: HashMap<(usize, usize), usize>,
+    point_perps: HashMap<usize, usize>,
+    line_perps: HashMap<usize, usize>,
+    stats: CacheStats,
+}
+
+impl<P, L> Default for Construction<P, L> {
+    fn default() -> Self {
+        Self {
+            points: Nodes::default(),
+            lines: Nodes::default(),
+            joins: HashMap::new(),
+            meets: HashMap::new(),
+            point_perps: HashMap::new(),
+            line_perps: HashMap::new(),
+            stats: CacheStats::default(),
+        }
+    }
+}
+
+/// `circ` keys are unordered: `a.circ(b)` and `b.circ(a)` are equal
+#[inline]
+fn key(a: usize, b: usize) -> (usize, usize) {
+    if a <= b {
+        (a, b)
+    } else {
+        (b, a)
+    }
+}
+
+impl<P, L> Construction<P, L>
+where
+    P: ProjPlanePrim<L> + Hash + Clone,
+    L: ProjPlanePrim<P> + Hash + Clone,
+{
+    #[inline]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /**
+    Add a point and return its id
+
+    Projectively equal points share the same id.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::construction::Construction;
+    use projgeom_rs::{PgLine, PgPoint};
+    let mut cons = Construction::<PgPoint, PgLine>::new();
+    let a = cons.insert_point(PgPoint::new([1, 2, 1]));
+    assert_eq!(cons.insert_point(PgPoint::new([-2, -4, -2])), a);
+    ```
+    */
+    #[inline]
+    pub fn insert_point(&mut self, p: P) -> PointId {
+        PointId(self.points.intern(p))
+    }
+
+    /// Add a line and return its id
+    #[inline]
+    pub fn insert_line(&mut self, l: L) -> LineId {
+        LineId(self.lines.intern(l))
+    }
+
+    #[inline]
+    pub fn point(&self, id: PointId) -> &P {
+        &self.points.objs[id.0]
+    }
+
+    #[inline]
+    pub fn line(&self, id: LineId) -> &L {
+        &self.lines.objs[id.0]
+    }
+
+    #[inline]
+    pub fn num_points(&self) -> usize {
+        self.points.objs.len()
+    }
+
+    #[inline]
+    pub fn num_lines(&self) -> usize {
+        self.lines.objs.len()
+    }
+
+    #[inline]
+    pub fn stats(&self) -> CacheStats {
+        self.stats
+    }
+
+    /**
+    The line through two distinct points
+
+    Panics if `a == b`: the join of a point with itself is not a line.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::construction::Construction;
+    use projgeom_rs::{PgLine, PgPoint};
+    let mut cons = Construction::<PgPoint, PgLine>::new();
+    let a = cons.insert_point(PgPoint::new([1, 3, 2]));
+    let b = cons.insert_point(PgPoint::new([-2, 1, -1]));
+    let l = cons.join(a, b);
+    assert_eq!(cons.join(b, a), l);
+    assert_eq!(cons.stats().hits, 1);
+    ```
+    */
+    pub fn join(&mut self, a: PointId, b: PointId) -> LineId {
+        assert_ne!(a, b, "join: coincident points");
+        let k = key(a.0, b.0);
+        if let Some(id) = self.joins.get(&k) {
+            self.stats.hits += 1;
+            return LineId(*id);
+        }
+        self.stats.misses += 1;
+        let l = self.points.objs[k.0].circ(&self.points.objs[k.1]);
+        let id = self.lines.intern(l);
+        self.joins.insert(k, id);
+        LineId(id)
+    }
+
+    /// The line through `a` and `b`, or `None` if they coincide
+    #[inline]
+    pub fn try_join(&mut self, a: PointId, b: PointId) -> Option<LineId> {
+        (a != b).then(|| self.join(a, b))
+    }
+
+    /// The point on two distinct lines; panics if `l == m`
+    pub fn meet(&mut self, l: LineId, m: LineId) -> PointId {
+        assert_ne!(l, m, "meet: coincident lines");
+        let k = key(l.0, m.0);
+        if let Some(id) = self.meets.get(&k) {
+            self.stats.hits += 1;
+            return PointId(*id);
+        }
+        self.stats.misses += 1;
+        let p = self.lines.objs[k.0].circ(&self.lines.objs[k.1]);
+        let id = self.points.intern(p);
+        self.meets.insert(k, id);
+        PointId(id)
+    }
+
+    /// The point on `l` and `m`, or `None` if they coincide
+    #[inline]
+    pub fn try_meet(&mut self, l: LineId, m: LineId) -> Option<PointId> {
+        (l != m).then(|| self.meet(l, m))
+    }
+
+    #[inline]
+    pub fn incident(&self, p: PointId, l: LineId) -> bool {
+        self.point(p).incident(self.line(l))
+    }
+
+    /// Whether `a`, `b` and `c` are collinear
+    pub fn coincident(&mut self, a: PointId, b: PointId, c: PointId) -> bool {
+        if a == b || b == c || a == c {
+            return true;
+        }
+        let l = self.join(a, b);
+        self.incident(c, l)
+    }
+
+    /// Whether the lines `l`, `m` and `n` pass through a common point
+    pub fn concurrent(&mut self, l: LineId, m: LineId, n: LineId) -> bool {
+        if l == m || m == n || l == n {
+            return true;
+        }
+        let p = self.meet(l, m);
+        self.incident(p, n)
+    }
+
+    /// Sides of a triangle, or `None` if its vertices are collinear (see `try_tri_dual`)
+    pub fn try_tri_dual(&mut self, tri: &[PointId; 3]) -> Option<[LineId; 3]> {
+        let [a1, a2, a3] = *tri;
+        if a1 == a2 || a2 == a3 || a1 == a3 {
+            return None;
+        }
+        let l1 = self.join(a2, a3);
+        if self.incident(a1, l1) {
+            return None; // coincident(a1, a2, a3)
+        }
+        Some([l1, self.join(a1, a3), self.join(a1, a2)])
+    }
+
+    #[inline]
+    pub fn tri_dual(&mut self, tri: &[PointId; 3]) -> [LineId; 3] {
+        self.try_tri_dual(tri)
+            .expect("tri_dual: degenerate triangle")
+    }
+
+    /**
+    Whether two triangles are perspective from a point (see `persp`)
+
+    A shared vertex makes the predicate trivially true, as in `persp`,
+    where the join of coincident points is the zero line.
+    */
+    pub fn persp(&mut self, tri1: &[PointId; 3], tri2: &[PointId; 3]) -> bool {
+        let [a, b, c] = *tri1;
+        let [d, e, f] = *tri2;
+        let (Some(ad), Some(be), Some(cf)) = (
+            self.try_join(a, d),
+            self.try_join(b, e),
+            self.try_join(c, f),
+        ) else {
+            return true;
+        };
+        self.concurrent(ad, be, cf)
+    }
+
+    /// Whether two trilaterals are perspective from a line; trivially true on a shared side
+    pub fn persp_dual(&mut self, tri1: &[LineId; 3], tri2: &[LineId; 3]) -> bool {
+        let [a, b, c] = *tri1;
+        let [d, e, f] = *tri2;
+        let (Some(ad), Some(be), Some(cf)) = (
+            self.try_meet(a, d),
+            self.try_meet(b, e),
+            self.try_meet(c, f),
+        ) else {
+            return true;
+        };
+        self.coincident(ad, be, cf)
+    }
+
+    /**
+    Check Desargues' theorem (see `check_desargue`)
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::construction::Construction;
+    use projgeom_rs::{PgLine, PgPoint};
+    let mut cons = Construction::<PgPoint, PgLine>::new();
+    let tri1 = [[1, 3, 1], [-2, 1, 1], [2, -2, 1]].map(|c| cons.insert_point(PgPoint::new(c)));
+    let tri2 = [[2, 6, 1], [-4, 2, 1], [4, -4, 1]].map(|c| cons.insert_point(PgPoint::new(c)));
+    assert!(cons.check_desargue(&tri1, &tri2));
+    ```
+    */
+    pub fn check_desargue(&mut self, tri1: &[PointId; 3], tri2: &[PointId; 3]) -> bool {
+        let trid1 = self.tri_dual(tri1);
+        let trid2 = self.tri_dual(tri2);
+        let b1 = self.persp(tri1, tri2);
+        let b2 = self.persp_dual(&trid1, &trid2);
+        b1 == b2
+    }
+
+    /// Check Pappus' theorem (see `check_pappus`); a degenerate join or meet makes it trivially true
+    pub fn check_pappus(&mut self, co1: &[PointId; 3], co2: &[PointId; 3]) -> bool {
+        let [a, b, c] = *co1;
+        let [d, e, f] = *co2;
+        let mut cross_point = |p, q, r, s| {
+            let (l, m) = (self.try_join(p, q)?, self.try_join(r, s)?);
+            self.try_meet(l, m)
+        };
+        let (Some(g), Some(h), Some(i)) = (
+            cross_point(a, e, b, d),
+            cross_point(a, f, c, d),
+            cross_point(b, f, c, e),
+        ) else {
+            return true;
+        };
+        self.coincident(g, h, i)
+    }
+
+    /**
+    Joins of many pairs; only pairs not yet in the graph are evaluated
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::construction::Construction;
+    use projgeom_rs::{PgLine, PgPoint};
+    let mut cons = Construction::<PgPoint, PgLine>::new();
+    let [a, b, c] = [[0, 0, 1], [1, 0, 1], [2, 0, 1]].map(|p| cons.insert_point(PgPoint::new(p)));
+    let ls = cons.join_many(&[(a, b), (b, c), (b, a)]);
+    assert!(ls[0] == ls[1] && ls[1] == ls[2]);
+    ```
+    */
+    pub fn join_many(&mut self, pairs: &[(PointId, PointId)]) -> Vec<LineId> {
+        let todo = pending(&self.joins, pairs.iter().map(|(a, b)| (a.0, b.0)));
+        let pts = &self.points.objs;
+        let lines: Vec<L> = todo.iter().map(|(a, b)| pts[*a].circ(&pts[*b])).collect();
+        self.finish_joins(todo, lines, pairs)
+    }
+
+    /// Meets of many pairs; only pairs not yet in the graph are evaluated
+    pub fn meet_many(&mut self, pairs: &[(LineId, LineId)]) -> Vec<PointId> {
+        let todo = pending(&self.meets, pairs.iter().map(|(l, m)| (l.0, m.0)));
+        let lines = &self.lines.objs;
+        let pts: Vec<P> = todo
+            .iter()
+            .map(|(l, m)| lines[*l].circ(&lines[*m]))
+            .collect();
+        self.finish_meets(todo, pts, pairs)
+    }
+
+    fn finish_joins(
+        &mut self,
+        todo: Vec<(usize, usize)>,
+        lines: Vec<L>,
+        pairs: &[(PointId, PointId)],
+    ) -> Vec<LineId> {
+        for (k, l) in todo.into_iter().zip(lines) {
+            let id = self.lines.intern(l);
+            self.joins.insert(k, id);
+        }
+        pairs.iter().map(|(a, b)| self.join(*a, *b)).collect()
+    }
+
+    fn finish_meets(
+        &mut self,
+        todo: Vec<(usize, usize)>,
+        pts: Vec<P>,
+        pairs: &[(LineId, LineId)],
+    ) -> Vec<PointId> {
+        for (k, p) in todo.into_iter().zip(pts) {
+            let id = self.points.intern(p);
+            self.meets.insert(k, id);
+        }
+        pairs.iter().map(|(l, m)| self.meet(*l, *m)).collect()
+    }
+}
+
+#[cfg(feature = "parallel")]
+impl<P, L> Construction<P, L>
+where
+    P: ProjPlanePrim<L> + Hash + Clone + Send + Sync,
+    L: ProjPlanePrim<P> + Hash + Clone + Send + Sync,
+{
+    /// `join_many` with the missing joins evaluated on the rayon pool
+    pub fn par_join_many(&mut self, pairs: &[(PointId, PointId)]) -> Vec<LineId> {
+        let todo = pending(&self.joins, pairs.iter().map(|(a, b)| (a.0, b.0)));
+        let pts = &self.points.objs;
+        let lines = par_eval(&todo, |(a, b)| pts[*a].circ(&pts[*b]));
+        self.finish_joins(todo, lines, pairs)
+    }
+
+    /// `meet_many` with the missing meets evaluated on the rayon pool
+    pub fn par_meet_many(&mut self, pairs: &[(LineId, LineId)]) -> Vec<PointId> {
+        let todo = pending(&self.meets, pairs.iter().map(|(l, m)| (l.0, m.0)));
+        let lines = &self.lines.objs;
+        let pts = par_eval(&todo, |(l, m)| lines[*l].circ(&lines[*m]));
+        self.finish_meets(todo, pts, pairs)
+    }
+}
+
+/// Distinct keys of `pairs` missing from `memo`
+fn pending(
+    memo: &HashMap<(usize, usize), usize>,
+    pairs: impl Iterator<Item = (usize, usize)>,
+) -> Vec<(usize, usize)> {
+    let mut todo: Vec<_> = pairs
+        .filter(|(a, b)| a != b)
+        .map(|(a, b)| key(a, b))
+        .filter(|k| !memo.contains_key(k))
+        .collect();
+    todo.sort_unstable();
+    todo.dedup();
+    todo
+}
+#[cfg(feature = "parallel")]
+fn par_eval<O, F>(todo: &[(usize, usize)], f: F) -> Vec<O>
+where
+    O: Send,
+    F: Fn(&(usize, usize)) -> O + Sync + Send,
+{
+    use crate::pg_parallel::MIN_LEN;
+    use rayon::prelude::*;
+    if todo.len() < MIN_LEN {
+        return todo.iter().map(f).collect();
+    }
+    todo.par_iter().with_min_len(MIN_LEN).map(f).collect()
+}
+
+impl<P, L> Construction<P, L>
+where
+    P: CKPlanePrim<L> + Hash + Clone,
+    L: CKPlanePrim<P> + Hash + Clone,
+{
+    /// The polar line of a point
+    pub fn perp_point(&mut self, p: PointId) -> LineId {
+        if let Some(id) = self.point_perps.get(&p.0) {
+            self.stats.hits += 1;
+            return LineId(*id);
+        }
+        self.stats.misses += 1;
+        let id = self.lines.intern(self.points.objs[p.0].perp());
+        self.point_perps.insert(p.0, id);
+        LineId(id)
+    }
+
+    /// The pole of a line
+    pub fn perp_line(&mut self, l: LineId) -> PointId {
+        if let Some(id) = self.line_perps.get(&l.0) {
+            self.stats.hits += 1;
+            return PointId(*id);
+        }
+        self.stats.misses += 1;
+        let id = self.points.intern(self.lines.objs[l.0].perp());
+        self.line_perps.insert(l.0, id);
+        PointId(id)
+    }
+
+    /// The line through `p` perpendicular to `l` (see `altitude`)
+    #[inline]
+    pub fn altitude(&mut self, p: PointId, l: LineId) -> LineId {
+        let pole = self.perp_line(l);
+        self.join(pole, p)
+    }
+
+    /// Altitudes of a triangle, or `None` if its vertices are collinear
+    pub fn try_tri_altitude(&mut self, tri: &[PointId; 3]) -> Option<[LineId; 3]> {
+        let [l1, l2, l3] = self.try_tri_dual(tri)?;
+        let [a1, a2, a3] = *tri;
+        Some([
+            self.altitude(a1, l1),
+            self.altitude(a2, l2),
+            self.altitude(a3, l3),
+        ])
+    }
+
+    /**
+    Orthocenter of a triangle, or `None` if its vertices are collinear
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::construction::Construction;
+    use projgeom_rs::{orthocenter, HypLine, HypPoint};
+    let coords = [[13, 23, 32], [44, -34, 2], [-2, 12, 23]];
+    let mut cons = Construction::<HypPoint, HypLine>::new();
+    let tri = coords.map(|c| cons.insert_point(HypPoint::new(c)));
+    let o = cons.try_orthocenter(&tri).unwrap();
+    assert_eq!(*cons.point(o), orthocenter(&coords.map(HypPoint::new)));
+    ```
+    */
+    pub fn try_orthocenter(&mut self, tri: &[PointId; 3]) -> Option<PointId> {
+        let [l1, l2, _] = self.try_tri_dual(tri)?;
+        let [a1, a2, _] = *tri;
+        let t1 = self.altitude(a1, l1);
+        let t2 = self.altitude(a2, l2);
+        Some(self.meet(t1, t2))
+    }
+
+    #[inline]
+    pub fn orthocenter(&mut self, tri: &[PointId; 3]) -> PointId {
+        self.try_orthocenter(tri)
+            .expect("orthocenter: degenerate triangle")
+    }
+}
+
+impl<P, L> Construction<P, L>
+where
+    P: ProjPlanePrim<L> + Hash + Clone,
+    L: ProjPlanePrim<P> + Hash + Clone,
+{
+    /// `ld * a + mu * b`, interned but not memoized: the coefficients are
+    /// arbitrary scalars and rarely repeat
+    pub fn plucker<V>(&mut self, ld: &V, a: PointId, mu: &V, b: PointId) -> PointId
+    where
+        V: Default + PartialEq,
+        P: ProjPlane<L, V>,
+    {
+        let p = self.points.objs[a.0].plucker(ld, &self.points.objs[b.0], mu);
+        PointId(self.points.intern(p))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ck_plane::orthocenter;
+    use crate::pg_object::{EllLine, EllPoint, PgLine, PgPoint};
+    use crate::pg_plane::{check_desargue, check_pappus};
+
+    #[test]
+    fn test_shared_subconstructions() {
+        let mut cons = Construction::<PgPoint, PgLine>::new();
+        // points of a parabola: no three are collinear
+        let coords: Vec<[i128; 3]> = (-6..6).map(|x| [x, x * x, 1]).collect();
+        let pts: Vec<PointId> = coords
+            .iter()
+            .map(|c| cons.insert_point(PgPoint::new(*c)))
+            .collect();
+        // overlapping triangle pairs share vertices and hence sides
+        for i in 0..6 {
+            let tri1 = [pts[i], pts[i + 1], pts[i + 2]];
+            let tri2 = [pts[i + 3], pts[i + 4], pts[i + 5]];
+            let c1 = tri1.map(|id| *cons.point(id));
+            let c2 = tri2.map(|id| *cons.point(id));
+            assert_eq!(
+                cons.check_desargue(&tri1, &tri2),
+                check_desargue::<_, PgLine>(&c1, &c2)
+            );
+        }
+        let before = cons.stats();
+        assert!(before.hits > 0);
+        // a second sweep is answered from the memo tables alone
+        for i in 0..6 {
+            let tri1 = [pts[i], pts[i + 1], pts[i + 2]];
+            let tri2 = [pts[i + 3], pts[i + 4], pts[i + 5]];
+            cons.check_desargue(&tri1, &tri2);
+        }
+        assert_eq!(cons.stats().misses, before.misses);
+
+        // Pappus: collinear triples on two lines
+        let co1 = [[0, 0, 1], [1, 1, 1], [3, 3, 1]].map(|c| cons.insert_point(PgPoint::new(c)));
+        let co2 = [[1, 0, 1], [3, 1, 1], [9, 4, 1]].map(|c| cons.insert_point(PgPoint::new(c)));
+        assert!(cons.coincident(co1[0], co1[1], co1[2]));
+        assert!(cons.check_pappus(&co1, &co2));
+        let c1 = co1.map(|id| *cons.point(id));
+        let c2 = co2.map(|id| *cons.point(id));
+        assert!(check_pappus::<_, PgLine>(&c1, &c2));
+    }
+
+    #[test]
+    fn test_shared_vertices() {
+        use crate::pg_plane::persp;
+        let mut cons = Construction::<PgPoint, PgLine>::new();
+        let coords: Vec<[i128; 3]> = (-3..4).map(|x| [x, x * x, 1]).collect();
+        let pts: Vec<PointId> = coords
+            .iter()
+            .map(|c| cons.insert_point(PgPoint::new(*c)))
+            .collect();
+        let coord =
+            |cons: &Construction<PgPoint, PgLine>, t: [PointId; 3]| t.map(|id| *cons.point(id));
+        // triangles sharing one vertex, in every position
+        for tri2 in [
+            [pts[0], pts[4], pts[5]],
+            [pts[3], pts[1], pts[5]],
+            [pts[3], pts[4], pts[2]],
+            [pts[1], pts[0], pts[5]],
+        ] {
+            let tri1 = [pts[0], pts[1], pts[2]];
+            let (c1, c2) = (coord(&cons, tri1), coord(&cons, tri2));
+            assert_eq!(cons.persp(&tri1, &tri2), persp::<_, PgLine>(&c1, &c2));
+            assert_eq!(
+                cons.check_desargue(&tri1, &tri2),
+                check_desargue::<_, PgLine>(&c1, &c2)
+            );
+        }
+        // Pappus with points shared between (or repeated within) the two rows
+        let co1 = [[0, 0, 1], [1, 1, 1], [3, 3, 1]].map(|c| cons.insert_point(PgPoint::new(c)));
+        let co2 = [[1, 0, 1], [3, 1, 1], [9, 4, 1]].map(|c| cons.insert_point(PgPoint::new(c)));
+        for (r1, r2) in [
+            (co1, [co2[0], co1[0], co2[2]]),
+            (co1, [co1[0], co2[1], co2[2]]),
+            (co1, [co2[0], co2[1], co1[2]]),
+            ([co1[0], co1[0], co1[2]], co2),
+        ] {
+            let (c1, c2) = (coord(&cons, r1), coord(&cons, r2));
+            assert_eq!(
+                cons.check_pappus(&r1, &r2),
+                check_pappus::<_, PgLine>(&c1, &c2)
+            );
+        }
+    }
+
+    #[test]
+    fn test_batches_and_perp() {
+        let mut cons = Construction::<EllPoint, EllLine>::new();
+        let coords = [[13, 23, 32], [44, -34, 2], [-2, 12, 23], [1, 5, 7]];
+        let pts = coords.map(|c| cons.insert_point(EllPoint::new(c)));
+        let pairs: Vec<(PointId, PointId)> = (0..4)
+            .flat_map(|i| {
+                (0..4)
+                    .filter(move |j| *j != i)
+                    .map(move |j| (pts[i], pts[j]))
+            })
+            .collect();
+        let ls = cons.join_many(&pairs);
+        // 12 ordered pairs, 6 distinct lines
+        assert_eq!(cons.num_lines(), 6);
+        for ((a, b), l) in pairs.iter().zip(&ls) {
+            assert_eq!(*cons.line(*l), cons.point(*a).circ(cons.point(*b)));
+        }
+        #[cfg(feature = "parallel")]
+        assert_eq!(cons.par_join_many(&pairs), ls);
+        let ps = cons.meet_many(&[(ls[0], ls[4]), (ls[1], ls[2])]);
+        assert_eq!(ps[1], pts[0]); // lines 02 and 03 meet in 0
+
+        let tri = [pts[0], pts[1], pts[2]];
+        let o = cons.orthocenter(&tri);
+        let expected = orthocenter(&[coords[0], coords[1], coords[2]].map(EllPoint::new));
+        assert_eq!(*cons.point(o), expected);
+        let alts = cons.try_tri_altitude(&tri).unwrap();
+        assert!(alts.iter().all(|t| cons.incident(o, *t)));
+        let q = cons.plucker(&2, pts[0], &3, pts[1]);
+        let l01 = cons.join(pts[0], pts[1]);
+        assert!(cons.incident(q, l01));
+    }
+}
@@ -1,20 +1,38 @@
-use crate::ck_plane::{CKPlane, CKPlanePrim};
-use crate::pg_object::{EllLine, EllPoint};
+use crate::ck_plane::{impl_fused_ck, CKPlane, CKPlanePrim};
+use crate::pg_object::{EllLineT, EllPointT, Scalar};
 
-impl CKPlanePrim<EllLine> for EllPoint {
+impl<T: Scalar> CKPlanePrim<EllLineT<T>> for EllPointT<T> {
     #[inline]
-    fn perp(&self) -> EllLine {
-        EllLine::new(self.coord)
+    fn perp(&self) -> EllLineT<T> {
+        EllLineT::new(self.coord)
     }
+
+    impl_fused_ck!(EllLineT<T>);
 }
 
-impl CKPlanePrim<EllPoint> for EllLine {
+impl<T: Scalar> CKPlanePrim<EllPointT<T>> for EllLineT<T> {
     #[inline]
-    fn perp(&self) -> EllPoint {
-        EllPoint::new(self.coord)
+    fn perp(&self) -> EllPointT<T> {
+        EllPointT::new(self.coord)
     }
+
+    impl_fused_ck!(EllPointT<T>);
 }
 
-impl CKPlane<EllLine, i128> for EllPoint {}
+impl<T: Scalar> CKPlane<EllLineT<T>, T> for EllPointT<T> {}
+
+impl<T: Scalar> CKPlane<EllPointT<T>, T> for EllLineT<T> {}
+
+impl EllPointT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> EllLineT<i128> {
+        EllLineT::new(self.coord)
+    }
+}
 
-impl CKPlane<EllPoint, i128> for EllLine {}
+impl EllLineT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> EllPointT<i128> {
+        EllPointT::new(self.coord)
+    }
+}
@@ -1,74 +1,249 @@
 // Euclidean Geometry
 
-use crate::ck_plane::{CKPlane, CKPlanePrim};
-use crate::pg_object::{EuclidLine, EuclidPoint};
-use crate::pg_plane::{coincident, tri_dual, ProjPlane, ProjPlanePrim};
+use crate::ck_plane::{impl_fused_ck, CKPlane, CKPlanePrim};
+use crate::pg_object::{EuclidLineT, EuclidPointT, Scalar};
+use crate::pg_plane::{ProjPlane, ProjPlanePrim};
 // use crate::pg_object::{plckr, dot};
 use crate::pg_object::dot1;
 
-// static I_RE: EuclidPoint = EuclidPoint { coord: [0, 1, 1] };
-// static I_IM: EuclidPoint = EuclidPoint { coord: [1, 0, 0] };
-static L_INF: EuclidLine = EuclidLine { coord: [0, 0, 1] };
+impl<T: Scalar> EuclidLineT<T> {
+    // pub const I_RE: EuclidPointT<T> = EuclidPointT { coord: [T::ZERO, T::ONE, T::ONE] };
+    // pub const I_IM: EuclidPointT<T> = EuclidPointT { coord: [T::ONE, T::ZERO, T::ZERO] };
+    pub const L_INF: Self = Self {
+        coord: [T::ZERO, T::ZERO, T::ONE],
+    };
+}
 
-impl CKPlanePrim<EuclidLine> for EuclidPoint {
+impl<T: Scalar> CKPlanePrim<EuclidLineT<T>> for EuclidPointT<T> {
     #[allow(dead_code)]
-    fn perp(&self) -> EuclidLine {
-        L_INF.clone()
+    fn perp(&self) -> EuclidLineT<T> {
+        EuclidLineT::L_INF
     }
+
+    impl_fused_ck!(EuclidLineT<T>);
 }
 
-impl CKPlanePrim<EuclidPoint> for EuclidLine {
+impl<T: Scalar> CKPlanePrim<EuclidPointT<T>> for EuclidLineT<T> {
     #[allow(dead_code)]
-    fn perp(&self) -> EuclidPoint {
-        EuclidPoint::new([self.coord[0], self.coord[1], 0])
+    fn perp(&self) -> EuclidPointT<T> {
+        EuclidPointT::new([self.coord[0], self.coord[1], T::ZERO])
     }
+
+    impl_fused_ck!(EuclidPointT<T>);
 }
 
-impl CKPlane<EuclidLine, i128> for EuclidPoint {}
+impl<T: Scalar> CKPlane<EuclidLineT<T>, T> for EuclidPointT<T> {}
 
-impl CKPlane<EuclidPoint, i128> for EuclidLine {}
+impl<T: Scalar> CKPlane<EuclidPointT<T>, T> for EuclidLineT<T> {}
 
-impl EuclidLine {
+impl<T: Scalar> EuclidLineT<T> {
     #[inline]
-    pub fn is_parallel(&self, other: &EuclidLine) -> bool {
+    pub fn is_parallel(&self, other: &EuclidLineT<T>) -> bool {
         self.coord[0] * other.coord[1] == self.coord[1] * other.coord[0]
     }
 
     #[inline]
-    pub fn is_perpendicular(&self, other: &EuclidLine) -> bool {
-        dot1(&self.coord, &other.coord) == 0
+    pub fn is_perpendicular(&self, other: &EuclidLineT<T>) -> bool {
+        dot1(&self.coord, &other.coord) == T::ZERO
     }
 
     #[inline]
-    pub fn altitude(&self, a: &EuclidPoint) -> EuclidLine {
+    pub fn altitude(&self, a: &EuclidPointT<T>) -> EuclidLineT<T> {
         self.perp().circ(a)
     }
 }
 
-impl EuclidPoint {
+impl<T: Scalar> EuclidPointT<T> {
     #[inline]
-    pub fn midpoint(&self, other: &EuclidPoint) -> EuclidPoint {
-        EuclidPoint::plucker(self, &other.coord[2], other, &self.coord[2])
+    pub fn midpoint(&self, other: &EuclidPointT<T>) -> EuclidPointT<T> {
+        EuclidPointT::plucker(self, &other.coord[2], other, &self.coord[2])
     }
 }
 
-#[allow(dead_code)]
-pub fn tri_altitude(tri: &[EuclidPoint; 3]) -> [EuclidLine; 3] {
-    let [l1, l2, l3] = tri_dual(tri);
+/**
+Affine point `(x, y)`, i.e. `EuclidPointT` with `z = 1`
+
+The constructions on affine points drop every product with `z`: a join
+costs 2 multiplies instead of 6, a midpoint none, and an altitude 2.
+Results that need not be affine (midpoints, meets) are `EuclidPointT`.
+
+Examples:
+
+```rust
+use projgeom_rs::euclid_object::AffinePoint;
+use projgeom_rs::{EuclidPoint, ProjPlanePrim};
+let (p, q) = (AffinePoint::new([1, 3]), AffinePoint::new([-2, 1]));
+let (hp, hq) = (EuclidPoint::from(p), EuclidPoint::from(q));
+assert_eq!(p.circ(&q), hp.circ(&hq));
+assert_eq!(p.midpoint(&q), hp.midpoint(&hq));
+assert_eq!(hp.to_affine(), Some(p));
+```
+*/
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct AffinePointT<T> {
+    /// Cartesian coordinate
+    pub coord: [T; 2],
+}
+
+pub type AffinePoint = AffinePointT<i128>;
+
+impl<T> AffinePointT<T> {
+    #[inline]
+    pub const fn new(coord: [T; 2]) -> Self {
+        Self { coord }
+    }
+}
+
+impl<T: Scalar> From<AffinePointT<T>> for EuclidPointT<T> {
+    #[inline]
+    fn from(p: AffinePointT<T>) -> Self {
+        EuclidPointT::new([p.coord[0], p.coord[1], T::ONE])
+    }
+}
+
+impl<T: Scalar> EuclidPointT<T> {
+    /// The affine point with the same position, or `None` if it is at
+    /// infinity or its Cartesian coordinates are not exact
+    #[inline]
+    pub fn to_affine(&self) -> Option<AffinePointT<T>> {
+        let [x, y, z] = self.coord;
+        if z == T::ZERO || x % z != T::ZERO || y % z != T::ZERO {
+            return None;
+        }
+        Some(AffinePointT::new([x / z, y / z]))
+    }
+}
+
+impl<T: Scalar> AffinePointT<T> {
+    /// The line through two points: `cross` with `z = 1`
+    #[inline]
+    pub fn circ(&self, other: &AffinePointT<T>) -> EuclidLineT<T> {
+        let ([x1, y1], [x2, y2]) = (self.coord, other.coord);
+        EuclidLineT::new([y1 - y2, x2 - x1, x1 * y2 - x2 * y1])
+    }
+
+    #[inline]
+    pub fn incident(&self, line: &EuclidLineT<T>) -> bool {
+        let ([x, y], [a, b, c]) = (self.coord, line.coord);
+        a * x + b * y + c == T::ZERO
+    }
+
+    #[inline]
+    pub fn midpoint(&self, other: &AffinePointT<T>) -> EuclidPointT<T> {
+        let ([x1, y1], [x2, y2]) = (self.coord, other.coord);
+        EuclidPointT::new([x1 + x2, y1 + y2, T::ONE + T::ONE])
+    }
+
+    /// The line through `self` perpendicular to `line`: `line.altitude(self)`
+    #[inline]
+    pub fn altitude(&self, line: &EuclidLineT<T>) -> EuclidLineT<T> {
+        let ([x, y], [a, b, _]) = (self.coord, line.coord);
+        EuclidLineT::new([b, -a, a * y - b * x])
+    }
+
+    /// Whether the segments `p1 q1` and `p2 q2` are parallel
+    #[inline]
+    pub fn is_parallel(seg1: &[Self; 2], seg2: &[Self; 2]) -> bool {
+        let ([dx1, dy1], [dx2, dy2]) = (direction(seg1), direction(seg2));
+        dx1 * dy2 == dy1 * dx2
+    }
+
+    /// Whether the segments `p1 q1` and `p2 q2` are perpendicular
+    #[inline]
+    pub fn is_perpendicular(seg1: &[Self; 2], seg2: &[Self; 2]) -> bool {
+        let ([dx1, dy1], [dx2, dy2]) = (direction(seg1), direction(seg2));
+        dx1 * dx2 + dy1 * dy2 == T::ZERO
+    }
+}
+
+#[inline]
+fn direction<T: Scalar>(seg: &[AffinePointT<T>; 2]) -> [T; 2] {
+    let ([x1, y1], [x2, y2]) = (seg[0].coord, seg[1].coord);
+    [x2 - x1, y2 - y1]
+}
+
+/**
+Orthocenter of an affine triangle, or `None` if its vertices are collinear
+
+Examples:
+
+```rust
+use projgeom_rs::euclid_object::{try_affine_orthocenter, AffinePoint};
+use projgeom_rs::EuclidPoint;
+let tri = [[0, 0], [4, 0], [1, 3]].map(AffinePoint::new);
+assert_eq!(try_affine_orthocenter(&tri), Some(EuclidPoint::new([1, 1, 1])));
+```
+*/
+#[inline]
+pub fn try_affine_orthocenter<T: Scalar>(tri: &[AffinePointT<T>; 3]) -> Option<EuclidPointT<T>> {
     let [a1, a2, a3] = tri;
-    assert!(!coincident(a1, a2, a3));
-    let t1 = l1.altitude(a1);
-    let t2 = l2.altitude(a2);
-    let t3 = l3.altitude(a3);
-    [t1, t2, t3]
+    let l1 = a2.circ(a3);
+    if a1.incident(&l1) {
+        return None; // coincident(a1, a2, a3)
+    }
+    let t1 = a1.altitude(&l1);
+    let t2 = a2.altitude(&a3.circ(a1));
+    Some(t1.circ(&t2))
 }
 
 #[allow(dead_code)]
 #[inline]
-pub fn orthocenter(tri: &[EuclidPoint; 3]) -> EuclidPoint {
-    let [a1, a2, a3] = tri;
-    assert!(!coincident(a1, a2, a3));
-    let t1 = a2.circ(a3).altitude(a1);
-    let t2 = a3.circ(a1).altitude(a2);
-    t1.circ(&t2)
+pub fn tri_altitude<T: Scalar>(tri: &[EuclidPointT<T>; 3]) -> [EuclidLineT<T>; 3] {
+    try_tri_altitude(tri).expect("tri_altitude: degenerate triangle")
+}
+
+#[inline]
+pub fn try_tri_altitude<T: Scalar>(tri: &[EuclidPointT<T>; 3]) -> Option<[EuclidLineT<T>; 3]> {
+    <EuclidPointT<T> as CKPlanePrim<_>>::try_tri_altitude(tri)
+}
+
+/// `tri_altitude` of a triangle known to be non-degenerate (checked in debug builds only)
+#[inline]
+pub fn tri_altitude_unchecked<T: Scalar>(tri: &[EuclidPointT<T>; 3]) -> [EuclidLineT<T>; 3] {
+    <EuclidPointT<T> as CKPlanePrim<_>>::tri_altitude_unchecked(tri)
+}
+
+#[allow(dead_code)]
+#[inline]
+pub fn orthocenter<T: Scalar>(tri: &[EuclidPointT<T>; 3]) -> EuclidPointT<T> {
+    try_orthocenter(tri).expect("orthocenter: degenerate triangle")
+}
+
+/**
+Orthocenter of a triangle, or `None` if its vertices are collinear
+
+Examples:
+
+```rust
+use projgeom_rs::euclid_object::try_orthocenter;
+use projgeom_rs::EuclidPoint;
+let tri = [[0, 0, 1], [4, 0, 1], [1, 3, 1]].map(EuclidPoint::new);
+assert_eq!(try_orthocenter(&tri), Some(EuclidPoint::new([1, 1, 1])));
+let flat = [[0, 0, 1], [1, 1, 1], [2, 2, 1]].map(EuclidPoint::new);
+assert_eq!(try_orthocenter(&flat), None);
+```
+*/
+#[inline]
+pub fn try_orthocenter<T: Scalar>(tri: &[EuclidPointT<T>; 3]) -> Option<EuclidPointT<T>> {
+    <EuclidPointT<T> as CKPlanePrim<_>>::try_orthocenter(tri)
+}
+
+/// `orthocenter` of a triangle known to be non-degenerate (checked in debug builds only)
+#[inline]
+pub fn orthocenter_unchecked<T: Scalar>(tri: &[EuclidPointT<T>; 3]) -> EuclidPointT<T> {
+    <EuclidPointT<T> as CKPlanePrim<_>>::orthocenter_unchecked(tri)
+}
+
+impl EuclidPointT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> EuclidLineT<i128> {
+        EuclidLineT::<i128>::L_INF
+    }
+}
+
+impl EuclidLineT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> EuclidPointT<i128> {
+        EuclidPointT::new([self.coord[0], self.coord[1], 0])
+    }
 }
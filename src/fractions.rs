@@ -10,12 +10,77 @@ use core::ops::{AddAssign, DivAssign, MulAssign, SubAssign};
 // use core::str::FromStr;
 use num_integer::gcd;
 use num_integer::Integer;
-use num_traits::{Num, NumAssign, One, Zero};
+use num_traits::{Num, NumAssign, One, PrimInt, Signed, Zero};
 // #[cfg(feature = "std")]
 // use std::error::Error;
 use std::cmp::Ordering;
+use std::fmt;
 use std::mem; // for swap
 
+use crate::metrics::{self, Op};
+
+/**
+ * Greatest common divisor by Stein's binary algorithm
+ *
+ * Shifts and subtractions only, which is considerably cheaper than the
+ * division-based Euclidean algorithm for the primitive integer types.
+ */
+pub trait BinaryGcd: Integer + Copy {
+    fn binary_gcd(self, other: Self) -> Self;
+}
+
+macro_rules! binary_gcd_impl {
+    ($($scalar:ident),*) => (
+        $(
+            impl BinaryGcd for $scalar {
+                #[inline]
+                fn binary_gcd(self, other: Self) -> Self {
+                    let mut a = self.unsigned_abs();
+                    let mut b = other.unsigned_abs();
+                    if a == 0 {
+                        return b as $scalar;
+                    }
+                    if b == 0 {
+                        return a as $scalar;
+                    }
+                    let shift = (a | b).trailing_zeros();
+                    a >>= a.trailing_zeros();
+                    loop {
+                        b >>= b.trailing_zeros();
+                        if a > b {
+                            mem::swap(&mut a, &mut b);
+                        }
+                        b -= a;
+                        if b == 0 {
+                            break;
+                        }
+                    }
+                    (a << shift) as $scalar
+                }
+            }
+        )*
+    );
+}
+
+binary_gcd_impl!(i8, i16, i32, i64, i128, isize);
+
+/**
+Greatest common divisor (binary algorithm)
+
+Examples:
+
+```rust
+use projgeom_rs::fractions::binary_gcd;
+assert_eq!(binary_gcd(12, -18), 6);
+assert_eq!(binary_gcd(0, -7), 7);
+```
+*/
+#[inline]
+pub fn binary_gcd<T: BinaryGcd>(a: T, b: T) -> T {
+    metrics::count(Op::Gcd);
+    a.binary_gcd(b)
+}
+
 #[derive(PartialEq, Eq, Copy, Clone, Hash, Debug)]
 pub struct Fraction<T: Integer> {
     /// numerator portion of the Fraction object
@@ -26,7 +91,7 @@ pub struct Fraction<T: Integer> {
 
 impl<T> Fraction<T>
 where
-    T: Integer + Zero + One + Neg<Output = T> + DivAssign + Copy,
+    T: Integer + Zero + One + Neg<Output = T> + DivAssign + Copy + BinaryGcd,
 {
     /**
     Create a new Fraction
@@ -59,7 +124,7 @@ where
     }
 }
 
-impl<T: Integer + Zero + One + DivAssign + Copy> Fraction<T> {
+impl<T: Integer + Zero + One + DivAssign + Copy + BinaryGcd> Fraction<T> {
     /**
      * @brief normalize to a canonical form
      *
@@ -67,7 +132,8 @@ impl<T: Integer + Zero + One + DivAssign + Copy> Fraction<T> {
      */
     #[inline]
     pub fn normalize2(&mut self) -> T {
-        let common = gcd(self.num, self.den);
+        metrics::count(Op::Normalize);
+        let common = binary_gcd(self.num, self.den);
         if common != One::one() && common != Zero::zero() {
             self.num /= common;
             self.den /= common;
@@ -209,7 +275,7 @@ impl<T: Integer + PartialEq + Copy + DivAssign> PartialEq<T> for Fraction<T> {
 }
 // impl<T: Num + Eq + Clone> Eq for Fraction<T> {}
 
-impl<T: Integer + PartialOrd + Copy + DivAssign> PartialOrd<T> for Fraction<T> {
+impl<T: Integer + PartialOrd + Copy + DivAssign + BinaryGcd> PartialOrd<T> for Fraction<T> {
     /**
     PartialOrd
 
@@ -277,6 +343,10 @@ impl<T: Integer + Ord + Copy + DivAssign> Ord for Fraction<T> {
     /**
     PartialOrd
 
+    Compares by the continued-fraction expansion (integer parts first,
+    then the reciprocals of the remainders), so neither side is
+    normalized and no intermediate product can overflow.
+
     Examples:
 
     ```rust
@@ -292,17 +362,31 @@ impl<T: Integer + Ord + Copy + DivAssign> Ord for Fraction<T> {
         if self.den == other.den {
             return self.num.cmp(&other.num);
         }
-        let mut lhs = Self {
-            num: self.num.clone(),
-            den: other.num.clone(),
-        };
-        let mut rhs = Self {
-            num: self.den.clone(),
-            den: other.den.clone(),
-        };
-        lhs.normalize2();
-        rhs.normalize2();
-        (lhs.num * rhs.den).cmp(&(lhs.den * rhs.num))
+        let zero = T::zero();
+        if self.den == zero {
+            return self.num.cmp(&zero);
+        }
+        if other.den == zero {
+            return zero.cmp(&other.num);
+        }
+        let (mut a, mut b) = (self.num, self.den);
+        let (mut c, mut d) = (other.num, other.den);
+        let mut flip = false;
+        loop {
+            let (q1, r1) = a.div_mod_floor(&b);
+            let (q2, r2) = c.div_mod_floor(&d);
+            let ord = if q1 != q2 {
+                q1.cmp(&q2)
+            } else if r1 == zero || r2 == zero {
+                r1.cmp(&r2)
+            } else {
+                // r1/b vs r2/d, i.e. b/r1 vs d/r2 reversed
+                (a, b, c, d) = (b, r1, d, r2);
+                flip = !flip;
+                continue;
+            };
+            return if flip { ord.reverse() } else { ord };
+        }
     }
 }
 
@@ -310,7 +394,7 @@ impl<T: Integer + Ord + Copy + DivAssign> Ord for Fraction<T> {
 
 impl<T> MulAssign for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Zero + One,
+    T: Integer + Copy + NumAssign + Zero + One + BinaryGcd,
 {
     fn mul_assign(&mut self, other: Self) {
         let mut rhs = other;
@@ -337,7 +421,7 @@ where
 
 impl<T> DivAssign for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One,
+    T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One + BinaryGcd,
 {
     fn div_assign(&mut self, other: Self) {
         let mut rhs = other;
@@ -364,7 +448,7 @@ where
 
 impl<T> SubAssign for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Zero + One,
+    T: Integer + Copy + NumAssign + Zero + One + BinaryGcd,
 {
     fn sub_assign(&mut self, other: Self) {
         if self.den == other.den {
@@ -373,18 +457,19 @@ where
             return;
         }
 
-        let mut rhs = other;
-        mem::swap(&mut self.den, &mut rhs.num);
-        let common_n = self.normalize2();
-        let mut common_d = rhs.normalize2();
-        mem::swap(&mut self.den, &mut rhs.num);
-        self.num = self.cross(&rhs);
-        self.den *= rhs.den;
-        mem::swap(&mut self.den, &mut common_d);
-        self.normalize2();
-        self.num *= common_n;
-        self.den *= common_d;
-        self.normalize2();
+        // Knuth, TAOCP 4.5.1: both operands are in canonical form
+        let common = binary_gcd(self.den, other.den);
+        if common == One::one() {
+            self.num = self.cross(&other);
+            self.den *= other.den;
+            return;
+        }
+        let l = self.den / common;
+        let r = other.den / common;
+        let t = self.num * r - l * other.num;
+        let common_t = binary_gcd(t, common);
+        self.num = t / common_t;
+        self.den = l * (other.den / common_t);
     }
 }
 
@@ -403,7 +488,7 @@ where
 
 impl<T> AddAssign for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Zero + One,
+    T: Integer + Copy + NumAssign + Zero + One + BinaryGcd,
 {
     fn add_assign(&mut self, other: Self) {
         if self.den == other.den {
@@ -412,18 +497,19 @@ where
             return;
         }
 
-        let mut rhs = other;
-        mem::swap(&mut self.den, &mut rhs.num);
-        let common_n = self.normalize2();
-        let mut common_d = rhs.normalize2();
-        mem::swap(&mut self.den, &mut rhs.num);
-        self.num = self.num * rhs.den + self.den * rhs.num;
-        self.den *= rhs.den;
-        mem::swap(&mut self.den, &mut common_d);
-        self.normalize2();
-        self.num *= common_n;
-        self.den *= common_d;
-        self.normalize2();
+        // Knuth, TAOCP 4.5.1: both operands are in canonical form
+        let common = binary_gcd(self.den, other.den);
+        if common == One::one() {
+            self.num = self.num * other.den + self.den * other.num;
+            self.den *= other.den;
+            return;
+        }
+        let l = self.den / common;
+        let r = other.den / common;
+        let t = self.num * r + l * other.num;
+        let common_t = binary_gcd(t, common);
+        self.num = t / common_t;
+        self.den = l * (other.den / common_t);
     }
 }
 
@@ -442,7 +528,7 @@ where
 
 impl<T> MulAssign<T> for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Zero + One,
+    T: Integer + Copy + NumAssign + Zero + One + BinaryGcd,
 {
     fn mul_assign(&mut self, other: T) {
         let mut rhs = other;
@@ -467,7 +553,7 @@ where
 
 impl<T> DivAssign<T> for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One,
+    T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One + BinaryGcd,
 {
     fn div_assign(&mut self, other: T) {
         let mut rhs = other;
@@ -492,22 +578,11 @@ where
 
 impl<T> SubAssign<T> for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Zero + One,
+    T: Integer + Copy + NumAssign + Zero + One + BinaryGcd,
 {
     fn sub_assign(&mut self, other: T) {
-        if self.den == One::one() {
-            self.num -= other;
-            self.normalize2();
-            return;
-        }
-
-        let mut rhs = other;
-        mem::swap(&mut self.den, &mut rhs);
-        let common_n = self.normalize2();
-        mem::swap(&mut self.den, &mut rhs);
-        self.num -= self.den * rhs;
-        self.normalize2();
-        self.num *= common_n;
+        // gcd(num - den * other, den) == gcd(num, den), already canonical
+        self.num -= self.den * other;
     }
 }
 
@@ -526,22 +601,11 @@ where
 
 impl<T> AddAssign<T> for Fraction<T>
 where
-    T: Integer + Copy + NumAssign + Zero + One,
+    T: Integer + Copy + NumAssign + Zero + One + BinaryGcd,
 {
     fn add_assign(&mut self, other: T) {
-        if self.den == One::one() {
-            self.num += other;
-            self.normalize2();
-            return;
-        }
-
-        let mut rhs = other;
-        mem::swap(&mut self.den, &mut rhs);
-        let common_n = self.normalize2();
-        mem::swap(&mut self.den, &mut rhs);
-        self.num += self.den * rhs;
-        self.normalize2();
-        self.num *= common_n;
+        // gcd(num + den * other, den) == gcd(num, den), already canonical
+        self.num += self.den * other;
     }
 }
 
@@ -562,7 +626,7 @@ macro_rules! forward_op_assign {
     (impl $imp:ident, $method:ident) => {
         impl<'a, T> $imp<&'a Fraction<T>> for Fraction<T>
         where
-            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One,
+            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One + BinaryGcd,
         {
             #[inline]
             fn $method(&mut self, other: &Self) {
@@ -572,7 +636,7 @@ macro_rules! forward_op_assign {
 
         impl<'a, T> $imp<&'a T> for Fraction<T>
         where
-            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One,
+            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One + BinaryGcd,
         {
             #[inline]
             fn $method(&mut self, other: &T) {
@@ -591,7 +655,7 @@ macro_rules! forward_op {
     (impl $imp:ident, $method:ident, $op_assign:ident) => {
         impl<T> $imp for Fraction<T>
         where
-            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One,
+            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One + BinaryGcd,
         {
             type Output = Self;
 
@@ -605,7 +669,7 @@ macro_rules! forward_op {
 
         impl<T> $imp<T> for Fraction<T>
         where
-            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One,
+            T: Integer + Copy + NumAssign + Neg<Output = T> + Zero + One + BinaryGcd,
         {
             type Output = Self;
 
@@ -624,6 +688,562 @@ forward_op!(impl Sub, sub, sub_assign);
 forward_op!(impl Mul, mul, mul_assign);
 forward_op!(impl Div, div, div_assign);
 
+impl<T: Integer + fmt::Display> fmt::Display for Fraction<T> {
+    /**
+    Display
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::Fraction;
+    assert_eq!(Fraction::new(6, -8).to_string(), "(-3/4)");
+    ```
+    */
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "({}/{})", self.num, self.den)
+    }
+}
+
+/**
+ * Fraction with deferred reduction
+ *
+ * Arithmetic skips the gcd entirely until the numerator or denominator
+ * grows beyond half the width of `T`, so that the next product cannot
+ * overflow because of a missing reduction. Comparison, equality and
+ * display operate on the reduced value.
+ */
+#[derive(Copy, Clone, Debug)]
+pub struct LazyFraction<T: Integer> {
+    num: T,
+    den: T,
+}
+
+impl<T> LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    /**
+    Create a new LazyFraction (not reduced)
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::fractions::LazyFraction;
+    use projgeom_rs::Fraction;
+    let mut f = LazyFraction::new(1, 6);
+    f += LazyFraction::new(1, 3);
+    assert_eq!(f.to_fraction(), Fraction::new(1, 2));
+    ```
+    */
+    #[inline]
+    pub fn new(num: T, den: T) -> Self {
+        let mut res = LazyFraction { num, den };
+        if res.den < T::zero() {
+            res.num = -res.num;
+            res.den = -res.den;
+        }
+        res
+    }
+
+    /// Bit length beyond which the operands are reduced
+    #[inline]
+    fn threshold() -> u32 {
+        T::zero().count_zeros() / 2 - 1
+    }
+
+    #[inline]
+    fn bits(&self) -> u32 {
+        let m = self.num.abs() | self.den;
+        T::zero().count_zeros() - m.leading_zeros()
+    }
+
+    /// Reduce to lowest terms
+    #[inline]
+    pub fn reduce(&mut self) {
+        metrics::count(Op::Normalize);
+        let common = binary_gcd(self.num, self.den);
+        if common > T::one() {
+            self.num /= common;
+            self.den /= common;
+        }
+    }
+
+    #[inline]
+    fn reduce_if_large(&mut self) {
+        if self.bits() > Self::threshold() {
+            self.reduce();
+        }
+    }
+
+    #[inline]
+    pub fn to_fraction(&self) -> Fraction<T> {
+        Fraction::new(self.num, self.den)
+    }
+}
+
+impl<T> From<Fraction<T>> for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn from(frac: Fraction<T>) -> Self {
+        LazyFraction {
+            num: frac.num,
+            den: frac.den,
+        }
+    }
+}
+
+impl<T> AddAssign for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn add_assign(&mut self, other: Self) {
+        if self.den == other.den {
+            self.num += other.num;
+        } else {
+            self.num = self.num * other.den + self.den * other.num;
+            self.den *= other.den;
+        }
+        self.reduce_if_large();
+    }
+}
+
+impl<T> SubAssign for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn sub_assign(&mut self, other: Self) {
+        if self.den == other.den {
+            self.num -= other.num;
+        } else {
+            self.num = self.num * other.den - self.den * other.num;
+            self.den *= other.den;
+        }
+        self.reduce_if_large();
+    }
+}
+
+impl<T> MulAssign for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn mul_assign(&mut self, other: Self) {
+        self.num *= other.num;
+        self.den *= other.den;
+        self.reduce_if_large();
+    }
+}
+
+impl<T> DivAssign for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn div_assign(&mut self, other: Self) {
+        self.num *= other.den;
+        self.den *= other.num;
+        if self.den < T::zero() {
+            self.num = -self.num;
+            self.den = -self.den;
+        }
+        self.reduce_if_large();
+    }
+}
+
+impl<T> Neg for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    type Output = Self;
+
+    #[inline]
+    fn neg(self) -> Self::Output {
+        LazyFraction {
+            num: -self.num,
+            den: self.den,
+        }
+    }
+}
+
+macro_rules! forward_lazy_op {
+    (impl $imp:ident, $method:ident, $op_assign:ident) => {
+        impl<T> $imp for LazyFraction<T>
+        where
+            T: PrimInt + Signed + NumAssign + BinaryGcd,
+        {
+            type Output = Self;
+
+            #[inline]
+            fn $method(self, other: Self) -> Self::Output {
+                let mut res = self;
+                res.$op_assign(other);
+                res
+            }
+        }
+    };
+}
+
+forward_lazy_op!(impl Add, add, add_assign);
+forward_lazy_op!(impl Sub, sub, sub_assign);
+forward_lazy_op!(impl Mul, mul, mul_assign);
+forward_lazy_op!(impl Div, div, div_assign);
+
+impl<T> PartialEq for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn eq(&self, other: &Self) -> bool {
+        self.to_fraction() == other.to_fraction()
+    }
+}
+
+impl<T> Eq for LazyFraction<T> where T: PrimInt + Signed + NumAssign + BinaryGcd {}
+
+impl<T> PartialOrd for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl<T> Ord for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn cmp(&self, other: &Self) -> Ordering {
+        self.to_fraction().cmp(&other.to_fraction())
+    }
+}
+
+impl<T> fmt::Display for LazyFraction<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd + fmt::Display,
+{
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        self.to_fraction().fmt(f)
+    }
+}
+
+/// Whether `n` is wider than half of `T` (`T::min_value()` included)
+#[inline]
+fn is_wide<T: PrimInt + Signed>(n: T) -> bool {
+    let m = if n == T::min_value() { n } else { n.abs() };
+    let bits = T::zero().count_zeros() - m.leading_zeros();
+    bits > T::zero().count_zeros() / 2 - 1
+}
+
+/// `a / l` against `b / r` for positive `l` and `r`, by continued fractions
+#[inline]
+fn cmp_unreduced<T>(a: T, l: T, b: T, r: T) -> Ordering
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    Fraction { num: a, den: l }.cmp(&Fraction { num: b, den: r })
+}
+
+/**
+ * Fractions sharing one denominator
+ *
+ * The numerators are stored contiguously over a single positive
+ * denominator, so element-wise arithmetic between vectors with the same
+ * denominator is a plain loop over the numerators. Like `LazyFraction`,
+ * the vector is only reduced once a numerator or the denominator grows
+ * beyond half the width of `T`; a reduction is one gcd sweep over the
+ * whole vector (stopping as soon as the common divisor reaches one)
+ * instead of one gcd per element. `reduce` forces it, e.g. at the end of
+ * a chunk. Comparison and equality operate on the values.
+ */
+#[derive(Clone, Debug)]
+pub struct FractionVec<T: Integer> {
+    num: Vec<T>,
+    den: T,
+}
+
+impl<T> FractionVec<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    /**
+    Create a new FractionVec `num[i] / den`
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::fractions::FractionVec;
+    use projgeom_rs::Fraction;
+    let mut v = FractionVec::new(vec![1, 2, 4], 6);
+    v.reduce();
+    assert_eq!(v.denominator(), 6);
+    assert_eq!(v.get(1), Fraction::new(1, 3));
+    v += &FractionVec::new(vec![1, 1, 1], 3);
+    assert_eq!(v.to_vec(), [Fraction::new(1, 2), Fraction::new(2, 3), Fraction::new(1, 1)]);
+    ```
+    */
+    pub fn new(mut num: Vec<T>, den: T) -> Self {
+        assert!(den != T::zero(), "FractionVec: zero denominator");
+        let den = if den < T::zero() {
+            num.iter_mut().for_each(|n| *n = -*n);
+            -den
+        } else {
+            den
+        };
+        let mut res = FractionVec { num, den };
+        res.reduce_if_large();
+        res
+    }
+
+    /// Integers, over the denominator one
+    #[inline]
+    pub fn from_integers(num: Vec<T>) -> Self {
+        FractionVec { num, den: T::one() }
+    }
+
+    /// Common-denominator form of `fracs` (the lcm of their denominators)
+    pub fn from_fractions(fracs: &[Fraction<T>]) -> Self {
+        let den = fracs
+            .iter()
+            .fold(T::one(), |l, f| l / binary_gcd(l, f.den) * f.den);
+        let num = fracs.iter().map(|f| f.num * (den / f.den)).collect();
+        let mut res = FractionVec { num, den };
+        res.reduce_if_large();
+        res
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.num.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.num.is_empty()
+    }
+
+    #[inline]
+    pub fn numerators(&self) -> &[T] {
+        &self.num
+    }
+
+    #[inline]
+    pub fn denominator(&self) -> T {
+        self.den
+    }
+
+    /// The `i`-th value in lowest terms
+    #[inline]
+    pub fn get(&self, i: usize) -> Fraction<T> {
+        Fraction::new(self.num[i], self.den)
+    }
+
+    pub fn to_vec(&self) -> Vec<Fraction<T>> {
+        (0..self.len()).map(|i| self.get(i)).collect()
+    }
+
+    /// Divide the numerators and the denominator by their common divisor
+    pub fn reduce(&mut self) {
+        metrics::count(Op::Normalize);
+        let mut common = self.den;
+        for n in &self.num {
+            if common == T::one() {
+                return;
+            }
+            common = binary_gcd(common, *n);
+        }
+        if common > T::one() {
+            self.num.iter_mut().for_each(|n| *n /= common);
+            self.den /= common;
+        }
+    }
+
+    /// Whether an entry is wider than half of `T`, so that a product of two
+    /// entries may overflow
+    #[inline]
+    fn is_large(&self) -> bool {
+        self.num.iter().any(|n| is_wide(*n)) || is_wide(self.den)
+    }
+
+    #[inline]
+    fn reduce_if_large(&mut self) {
+        if self.is_large() {
+            self.reduce();
+        }
+    }
+
+    /**
+    Element-wise comparison `self[i].cmp(&other[i])`
+
+    Examples:
+
+    ```rust
+    use core::cmp::Ordering::*;
+    use projgeom_rs::fractions::FractionVec;
+    let a = FractionVec::new(vec![1, 2, 3], 4);
+    let b = FractionVec::new(vec![1, 1, 1], 2);
+    assert_eq!(a.cmp_many(&b), [Less, Equal, Greater]);
+    ```
+    */
+    pub fn cmp_many(&self, other: &Self) -> Vec<Ordering> {
+        assert_eq!(self.len(), other.len());
+        if self.den == other.den {
+            return self
+                .num
+                .iter()
+                .zip(&other.num)
+                .map(|(a, b)| a.cmp(b))
+                .collect();
+        }
+        let (l, r) = (self.den, other.den);
+        if self.is_large() || other.is_large() {
+            // the cross products may overflow: compare without multiplying
+            return self
+                .num
+                .iter()
+                .zip(&other.num)
+                .map(|(a, b)| cmp_unreduced(*a, l, *b, r))
+                .collect();
+        }
+        self.num
+            .iter()
+            .zip(&other.num)
+            .map(|(a, b)| (*a * r).cmp(&(*b * l)))
+            .collect()
+    }
+
+    /// Element-wise comparison with a single value
+    pub fn cmp_with(&self, frac: &Fraction<T>) -> Vec<Ordering> {
+        let (num, den) = if frac.den < T::zero() {
+            (-frac.num, -frac.den)
+        } else {
+            (frac.num, frac.den)
+        };
+        if self.is_large() || is_wide(num) || is_wide(den) {
+            return self
+                .num
+                .iter()
+                .map(|a| cmp_unreduced(*a, self.den, num, den))
+                .collect();
+        }
+        let (lhs, rhs) = (den, num * self.den);
+        self.num.iter().map(|a| (*a * lhs).cmp(&rhs)).collect()
+    }
+
+    /// `self[i] op= other[i]` for `op` in {+, -}
+    #[inline]
+    fn add_or_sub(&mut self, other: &Self, add: bool) {
+        assert_eq!(self.len(), other.len());
+        if self.den == other.den {
+            if add {
+                self.num
+                    .iter_mut()
+                    .zip(&other.num)
+                    .for_each(|(a, b)| *a += *b);
+            } else {
+                self.num
+                    .iter_mut()
+                    .zip(&other.num)
+                    .for_each(|(a, b)| *a -= *b);
+            }
+        } else {
+            // bring both over lcm(den, other.den), as Fraction::add_assign does
+            let common = binary_gcd(self.den, other.den);
+            let (l, r) = (self.den / common, other.den / common);
+            if add {
+                for (a, b) in self.num.iter_mut().zip(&other.num) {
+                    *a = *a * r + *b * l;
+                }
+            } else {
+                for (a, b) in self.num.iter_mut().zip(&other.num) {
+                    *a = *a * r - *b * l;
+                }
+            }
+            self.den = l * other.den;
+        }
+        self.reduce_if_large();
+    }
+}
+
+impl<T> AddAssign<&FractionVec<T>> for FractionVec<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn add_assign(&mut self, other: &Self) {
+        self.add_or_sub(other, true);
+    }
+}
+
+impl<T> SubAssign<&FractionVec<T>> for FractionVec<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    #[inline]
+    fn sub_assign(&mut self, other: &Self) {
+        self.add_or_sub(other, false);
+    }
+}
+
+impl<T> MulAssign<&FractionVec<T>> for FractionVec<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    /// Element-wise product
+    fn mul_assign(&mut self, other: &Self) {
+        assert_eq!(self.len(), other.len());
+        self.num
+            .iter_mut()
+            .zip(&other.num)
+            .for_each(|(a, b)| *a *= *b);
+        self.den *= other.den;
+        self.reduce_if_large();
+    }
+}
+
+impl<T> MulAssign<Fraction<T>> for FractionVec<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    /// Scale every element by `frac`
+    fn mul_assign(&mut self, frac: Fraction<T>) {
+        let (num, den) = if frac.den < T::zero() {
+            (-frac.num, -frac.den)
+        } else {
+            (frac.num, frac.den)
+        };
+        self.num.iter_mut().for_each(|a| *a *= num);
+        self.den *= den;
+        self.reduce_if_large();
+    }
+}
+
+impl<T> PartialEq for FractionVec<T>
+where
+    T: PrimInt + Signed + NumAssign + BinaryGcd,
+{
+    fn eq(&self, other: &Self) -> bool {
+        let (l, r) = (self.den, other.den);
+        if self.len() != other.len() {
+            return false;
+        }
+        let mut pairs = self.num.iter().zip(&other.num);
+        if self.is_large() || other.is_large() {
+            pairs.all(|(a, b)| cmp_unreduced(*a, l, *b, r) == Ordering::Equal)
+        } else {
+            pairs.all(|(a, b)| *a * r == *b * l)
+        }
+    }
+}
+
+impl<T> Eq for FractionVec<T> where T: PrimInt + Signed + NumAssign + BinaryGcd {}
+
 // /**
 //  * @brief multiply
 //  *
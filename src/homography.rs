@@ -0,0 +1,271 @@
+// Projective transformations of the plane
+//
+// A `Homography` is a 3x3 matrix acting on point coordinates by `x -> M x`.
+// Lines transform by the inverse transpose, which up to scale is the
+// transposed adjugate, so integer matrices never need a division. The
+// matrix of a construction like `involution` or `reflect` is built once and
+// then applied to any number of points at 9 multiplies each; `apply_many`
+// does so over structure-of-arrays columns (see `pg_batch`).
+//
+// Matrices are compared exactly, not projectively: `h` and `2 h` act the
+// same on points but are different values.
+
+use crate::ck_plane::CKPlanePrim;
+use crate::pg_object::{dot, Scalar};
+use core::ops::Mul;
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct Homography<T> {
+    /// Row-major matrix
+    pub mat: [[T; 3]; 3],
+}
+
+impl<T> Homography<T> {
+    #[inline]
+    pub const fn new(mat: [[T; 3]; 3]) -> Self {
+        Self { mat }
+    }
+}
+
+impl<T: Scalar> Homography<T> {
+    #[inline]
+    pub fn identity() -> Self {
+        let (o, z) = (T::ONE, T::ZERO);
+        Self::new([[o, z, z], [z, o, z], [z, z, o]])
+    }
+
+    /**
+    The harmonic homology with center `origin` and axis `mirror`
+
+    Acts on points like `pg_plane::involution(origin, mirror, _)`, up to
+    scale: `(o . m) I - 2 o m^T`.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::homography::Homography;
+    use projgeom_rs::{involution, PgLine, PgPoint};
+    let (origin, mirror) = (PgPoint::new([1, 1, 5]), PgLine::new([3, -1, 7]));
+    let h = Homography::involution(&origin, &mirror);
+    let p = PgPoint::new([2, 5, 3]);
+    assert_eq!(h.apply(&p), involution(&origin, &mirror, &p));
+    ```
+    */
+    pub fn involution<P, L>(origin: &P, mirror: &L) -> Self
+    where
+        P: AsRef<[T; 3]>,
+        L: AsRef<[T; 3]>,
+    {
+        let (o, m) = (origin.as_ref(), mirror.as_ref());
+        let om = dot(o, m);
+        let two = T::ONE + T::ONE;
+        let mut mat = [[T::ZERO; 3]; 3];
+        for i in 0..3 {
+            for j in 0..3 {
+                mat[i][j] = -(two * o[i] * m[j]);
+            }
+            mat[i][i] = mat[i][i] + om;
+        }
+        Self::new(mat)
+    }
+
+    /**
+    The reflection about `mirror`, as `ck_plane::reflect(mirror, _)`
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::homography::Homography;
+    use projgeom_rs::{reflect, HypLine, HypPoint};
+    let mirror = HypLine::new([3, -1, 7]);
+    let h = Homography::reflect::<HypPoint, _>(&mirror);
+    let p = HypPoint::new([2, 5, 3]);
+    assert_eq!(h.apply(&p), reflect(&mirror, &p));
+    ```
+    */
+    #[inline]
+    pub fn reflect<P, L>(mirror: &L) -> Self
+    where
+        P: CKPlanePrim<L> + AsRef<[T; 3]>,
+        L: CKPlanePrim<P> + AsRef<[T; 3]>,
+    {
+        Self::involution(&mirror.perp(), mirror)
+    }
+
+    #[inline]
+    pub fn transpose(&self) -> Self {
+        let m = &self.mat;
+        Self::new([0, 1, 2].map(|i| [m[0][i], m[1][i], m[2][i]]))
+    }
+
+    #[inline]
+    pub fn det(&self) -> T {
+        let m = &self.mat;
+        m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+            - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+            + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])
+    }
+
+    /// Adjugate matrix: `h * h.adjugate() == det(h) I`, so it is the
+    /// inverse transformation up to scale
+    pub fn adjugate(&self) -> Self {
+        let m = &self.mat;
+        let minor = |i: usize, j: usize| {
+            let (r0, r1) = ((i + 1) % 3, (i + 2) % 3);
+            let (c0, c1) = ((j + 1) % 3, (j + 2) % 3);
+            m[r0][c0] * m[r1][c1] - m[r0][c1] * m[r1][c0]
+        };
+        // cyclic indices make the cofactor signs come out of the minors
+        Self::new([0, 1, 2].map(|i| [0, 1, 2].map(|j| minor(j, i))))
+    }
+
+    /**
+    The matrix acting on line coordinates: the transposed adjugate
+
+    Incidence is preserved: `h.apply(p)` lies on `h.line_map().apply(l)`
+    whenever `p` lies on `l`.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::homography::Homography;
+    use projgeom_rs::{PgLine, PgPoint, ProjPlanePrim};
+    let h = Homography::new([[2, 1, 0], [0, 1, 3], [1, 0, 1]]);
+    let (p, q) = (PgPoint::new([1, 3, 2]), PgPoint::new([-2, 1, -1]));
+    let l: PgLine = p.circ(&q);
+    assert!(h.apply(&p).incident(&h.line_map().apply(&l)));
+    ```
+    */
+    #[inline]
+    pub fn line_map(&self) -> Self {
+        self.adjugate().transpose()
+    }
+
+    /// `M x`
+    #[inline]
+    pub fn apply_coord(&self, x: &[T; 3]) -> [T; 3] {
+        let m = &self.mat;
+        [dot(&m[0], x), dot(&m[1], x), dot(&m[2], x)]
+    }
+
+    #[inline]
+    pub fn apply<O>(&self, obj: &O) -> O
+    where
+        O: AsRef<[T; 3]> + From<[T; 3]>,
+    {
+        O::from(self.apply_coord(obj.as_ref()))
+    }
+
+    pub fn apply_slice<O>(&self, objs: &[O]) -> Vec<O>
+    where
+        O: AsRef<[T; 3]> + From<[T; 3]>,
+    {
+        objs.iter().map(|o| self.apply(o)).collect()
+    }
+
+    /**
+    Apply to a structure-of-arrays batch of coordinates
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::homography::Homography;
+    let h = Homography::new([[0, 1, 0], [1, 0, 0], [0, 0, 2]]);
+    let (mut x, mut y, mut z) = (vec![0; 2], vec![0; 2], vec![0; 2]);
+    h.apply_many([&[1, 4], &[2, 5], &[3, 6]], [&mut x, &mut y, &mut z]);
+    assert_eq!((x, y, z), (vec![2, 5], vec![1, 4], vec![6, 12]));
+    ```
+    */
+    #[inline]
+    pub fn apply_many(&self, p: [&[T]; 3], out: [&mut [T]; 3]) {
+        let n = out[0].len();
+        let [[a, b, c], [d, e, f], [g, h, k]] = self.mat;
+        let [px, py, pz] = p;
+        let (px, py, pz) = (&px[..n], &py[..n], &pz[..n]);
+        let [ox, oy, oz] = out;
+        let (oy, oz) = (&mut oy[..n], &mut oz[..n]);
+        for i in 0..n {
+            let (x, y, z) = (px[i], py[i], pz[i]);
+            ox[i] = a * x + b * y + c * z;
+            oy[i] = d * x + e * y + f * z;
+            oz[i] = g * x + h * y + k * z;
+        }
+    }
+}
+
+impl<T: Scalar> Mul for Homography<T> {
+    type Output = Homography<T>;
+
+    /// Composition: `(g * h).apply(p) == g.apply(&h.apply(p))`
+    #[inline]
+    fn mul(self, other: Homography<T>) -> Homography<T> {
+        let t = other.transpose();
+        Self::new(self.mat.map(|row| t.mat.map(|col| dot(&row, &col))))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ck_plane::reflect;
+    use crate::pg_batch::MyCKPointBatch;
+    use crate::pg_object::{HypLine, HypPoint, MyCKLine, MyCKPoint, PgLine, PgPoint};
+    use crate::pg_plane::{involution, ProjPlanePrim};
+
+    fn points() -> Vec<[i128; 3]> {
+        (0..50)
+            .map(|i| [i % 7 - 3, (i * 5) % 11 - 5, i % 4 + 1])
+            .collect()
+    }
+
+    #[test]
+    fn test_matches_constructions() {
+        let (origin, mirror) = (PgPoint::new([1, 1, 5]), PgLine::new([3, -1, 7]));
+        let h = Homography::involution(&origin, &mirror);
+        let mh = Homography::reflect::<MyCKPoint, _>(&MyCKLine::new([3, -1, 7]));
+        let hh = Homography::reflect::<HypPoint, _>(&HypLine::new([3, -1, 7]));
+        for c in points() {
+            assert_eq!(
+                h.apply(&PgPoint::new(c)),
+                involution(&origin, &mirror, &PgPoint::new(c))
+            );
+            let (p, m) = (MyCKPoint::new(c), MyCKLine::new([3, -1, 7]));
+            assert_eq!(mh.apply(&p), reflect(&m, &p));
+            let (p, m) = (HypPoint::new(c), HypLine::new([3, -1, 7]));
+            assert_eq!(hh.apply(&p), reflect(&m, &p));
+        }
+
+        // batches agree with point-by-point application
+        let pts: Vec<MyCKPoint> = points().into_iter().map(MyCKPoint::new).collect();
+        let batch = MyCKPointBatch::from_slice(&pts);
+        assert_eq!(batch.transform(&mh).to_vec(), mh.apply_slice(&pts));
+    }
+
+    #[test]
+    fn test_algebra() {
+        let g = Homography::new([[2, 1, 0], [0, 1, 3], [1, 0, 1]]);
+        let h = Homography::involution(&PgPoint::new([1, 1, 5]), &PgLine::new([3, -1, 7]));
+        let p = PgPoint::new([2, 5, 3]);
+        assert_eq!((g * h).apply(&p).coord, g.apply(&h.apply(&p)).coord);
+
+        let det = g.det();
+        assert_eq!(
+            g * g.adjugate(),
+            Homography::new([[det, 0, 0], [0, det, 0], [0, 0, det]])
+        );
+        assert_eq!(g.adjugate() * g, g * g.adjugate());
+        // an involution squares to a nonzero scalar
+        let s = (h * h).mat[0][0];
+        assert_ne!(s, 0);
+        assert_eq!(h * h, Homography::new([[s, 0, 0], [0, s, 0], [0, 0, s]]));
+
+        // lines through the image of a point are the images of lines through it
+        let gl = g.line_map();
+        for c in points() {
+            let (p, q) = (PgPoint::new(c), PgPoint::new([c[1], 2, -c[0]]));
+            let l = p.circ(&q);
+            assert_eq!(gl.apply(&l), g.apply(&p).circ(&g.apply(&q)));
+        }
+        assert_eq!(Homography::identity() * g, g);
+    }
+}
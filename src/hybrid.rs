@@ -0,0 +1,249 @@
+// Overflow-safe hybrid scalar
+//
+// Values are kept in i64 while they fit; every operation is checked and
+// a result that does not fit is promoted to i128. Results that fit back
+// into i64 are demoted again so that later operations return to the fast
+// path. Overflowing i128 panics, in release builds as well.
+
+use crate::pg_object::Scalar;
+use core::cmp::Ordering;
+use core::hash::{Hash, Hasher};
+use core::ops::{Add, Div, Mul, Neg, Rem, Sub};
+use num_traits::{Num, One, Zero};
+
+#[derive(Copy, Clone, Debug)]
+pub enum Hybrid {
+    Small(i64),
+    Large(i128),
+}
+
+impl Hybrid {
+    /**
+    From an i128, using the small representation when possible
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::hybrid::Hybrid;
+    assert!(Hybrid::from_i128(3).is_small());
+    assert!(!Hybrid::from_i128(1 << 70).is_small());
+    ```
+    */
+    #[inline]
+    pub fn from_i128(value: i128) -> Self {
+        match i64::try_from(value) {
+            Ok(v) => Hybrid::Small(v),
+            Err(_) => Hybrid::Large(value),
+        }
+    }
+
+    #[inline]
+    pub fn value(&self) -> i128 {
+        match *self {
+            Hybrid::Small(v) => v as i128,
+            Hybrid::Large(v) => v,
+        }
+    }
+
+    #[inline]
+    pub fn is_small(&self) -> bool {
+        matches!(self, Hybrid::Small(_))
+    }
+}
+
+#[inline]
+fn promoted(value: Option<i128>) -> Hybrid {
+    Hybrid::from_i128(value.expect("Hybrid: coordinate overflow beyond i128"))
+}
+
+macro_rules! hybrid_op {
+    (impl $imp:ident, $method:ident, $checked:ident $(, $zero:literal)?) => {
+        impl $imp for Hybrid {
+            type Output = Hybrid;
+
+            #[inline]
+            fn $method(self, other: Hybrid) -> Hybrid {
+                // a zero divisor panics as for the primitives, not as an overflow
+                $(if other.value() == 0 {
+                    panic!($zero);
+                })?
+                if let (Hybrid::Small(a), Hybrid::Small(b)) = (self, other) {
+                    if let Some(v) = a.$checked(b) {
+                        return Hybrid::Small(v);
+                    }
+                }
+                promoted(self.value().$checked(other.value()))
+            }
+        }
+    };
+}
+
+hybrid_op!(impl Add, add, checked_add);
+hybrid_op!(impl Sub, sub, checked_sub);
+hybrid_op!(impl Mul, mul, checked_mul);
+hybrid_op!(impl Div, div, checked_div, "attempt to divide by zero");
+hybrid_op!(
+    impl Rem,
+    rem,
+    checked_rem,
+    "attempt to calculate the remainder with a divisor of zero"
+);
+
+impl Neg for Hybrid {
+    type Output = Hybrid;
+
+    #[inline]
+    fn neg(self) -> Hybrid {
+        if let Hybrid::Small(a) = self {
+            if let Some(v) = a.checked_neg() {
+                return Hybrid::Small(v);
+            }
+        }
+        promoted(self.value().checked_neg())
+    }
+}
+
+impl PartialEq for Hybrid {
+    #[inline]
+    fn eq(&self, other: &Hybrid) -> bool {
+        match (self, other) {
+            (Hybrid::Small(a), Hybrid::Small(b)) => a == b,
+            _ => self.value() == other.value(),
+        }
+    }
+}
+impl Eq for Hybrid {}
+
+impl PartialOrd for Hybrid {
+    #[inline]
+    fn partial_cmp(&self, other: &Hybrid) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for Hybrid {
+    #[inline]
+    fn cmp(&self, other: &Hybrid) -> Ordering {
+        self.value().cmp(&other.value())
+    }
+}
+
+impl Hash for Hybrid {
+    #[inline]
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.value().hash(state)
+    }
+}
+
+impl Default for Hybrid {
+    #[inline]
+    fn default() -> Self {
+        Hybrid::Small(0)
+    }
+}
+
+impl Zero for Hybrid {
+    #[inline]
+    fn zero() -> Self {
+        Hybrid::Small(0)
+    }
+
+    #[inline]
+    fn is_zero(&self) -> bool {
+        *self == Hybrid::Small(0)
+    }
+}
+
+impl One for Hybrid {
+    #[inline]
+    fn one() -> Self {
+        Hybrid::Small(1)
+    }
+}
+
+impl Num for Hybrid {
+    type FromStrRadixErr = core::num::ParseIntError;
+
+    fn from_str_radix(s: &str, radix: u32) -> Result<Self, Self::FromStrRadixErr> {
+        i128::from_str_radix(s, radix).map(Hybrid::from_i128)
+    }
+}
+
+impl Scalar for Hybrid {
+    const ZERO: Self = Hybrid::Small(0);
+    const ONE: Self = Hybrid::Small(1);
+    const NEG_ONE: Self = Hybrid::Small(-1);
+}
+
+impl From<i64> for Hybrid {
+    #[inline]
+    fn from(value: i64) -> Self {
+        Hybrid::Small(value)
+    }
+}
+
+impl From<i32> for Hybrid {
+    #[inline]
+    fn from(value: i32) -> Self {
+        Hybrid::Small(value as i64)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_object::{PgPoint, PgPointT};
+    use crate::pg_plane::{check_pappus, ProjPlane, ProjPlanePrim};
+
+    fn hybrid(coord: [i64; 3]) -> PgPointT<Hybrid> {
+        PgPointT::new(coord.map(Hybrid::from))
+    }
+
+    #[test]
+    fn test_hybrid_promotion() {
+        let big = 5_000_000_000_i64;
+        let p = hybrid([big, 3, 2]);
+        let q = hybrid([-2, big, -1]);
+        let l = p.circ(&q);
+        assert!(!l.coord[2].is_small());
+        let expected = PgPoint::new([big as i128, 3, 2]).circ(&PgPoint::new([-2, big as i128, -1]));
+        assert_eq!(l.coord.map(|c| c.value()), expected.coord);
+        assert!(l.incident(&p) && l.incident(&q));
+
+        let r = hybrid([1, 1, 1]);
+        assert!(hybrid([big, big, 2])
+            .circ(&r)
+            .coord
+            .iter()
+            .all(Hybrid::is_small));
+    }
+
+    #[test]
+    fn test_hybrid_pappus() {
+        // intermediate values exceed i64 but stay within i128
+        let (a, b) = (hybrid([101, 307, 195]), hybrid([-197, 111, -100]));
+        let (d, e) = (hybrid([131, 230, 317]), hybrid([440, -333, 21]));
+        let c = a.plucker(&Hybrid::from(2), &b, &Hybrid::from(3));
+        let f = d.plucker(&Hybrid::from(3), &e, &Hybrid::from(-2));
+        assert!(check_pappus(&[a, b, c], &[d, e, f]));
+    }
+
+    #[test]
+    #[should_panic(expected = "overflow")]
+    fn test_hybrid_overflow() {
+        let huge = Hybrid::from_i128(i128::MAX / 2);
+        let _ = huge * Hybrid::from(3);
+    }
+
+    #[test]
+    #[should_panic(expected = "attempt to divide by zero")]
+    fn test_hybrid_div_zero() {
+        let _ = Hybrid::from(7) / Hybrid::from(0);
+    }
+
+    #[test]
+    #[should_panic(expected = "divisor of zero")]
+    fn test_hybrid_rem_zero() {
+        let _ = Hybrid::from_i128(i128::MAX) % Hybrid::from(0);
+    }
+}
@@ -1,20 +1,38 @@
-use crate::ck_plane::{CKPlane, CKPlanePrim};
-use crate::pg_object::{HypLine, HypPoint};
+use crate::ck_plane::{impl_fused_ck, CKPlane, CKPlanePrim};
+use crate::pg_object::{HypLineT, HypPointT, Scalar};
 
-impl CKPlanePrim<HypLine> for HypPoint {
+impl<T: Scalar> CKPlanePrim<HypLineT<T>> for HypPointT<T> {
     #[inline]
-    fn perp(&self) -> HypLine {
-        HypLine::new([self.coord[0], self.coord[1], -self.coord[2]])
+    fn perp(&self) -> HypLineT<T> {
+        HypLineT::new([self.coord[0], self.coord[1], -self.coord[2]])
     }
+
+    impl_fused_ck!(HypLineT<T>);
 }
 
-impl CKPlanePrim<HypPoint> for HypLine {
+impl<T: Scalar> CKPlanePrim<HypPointT<T>> for HypLineT<T> {
     #[inline]
-    fn perp(&self) -> HypPoint {
-        HypPoint::new([self.coord[0], self.coord[1], -self.coord[2]])
+    fn perp(&self) -> HypPointT<T> {
+        HypPointT::new([self.coord[0], self.coord[1], -self.coord[2]])
     }
+
+    impl_fused_ck!(HypPointT<T>);
 }
 
-impl CKPlane<HypLine, i128> for HypPoint {}
+impl<T: Scalar> CKPlane<HypLineT<T>, T> for HypPointT<T> {}
+
+impl<T: Scalar> CKPlane<HypPointT<T>, T> for HypLineT<T> {}
+
+impl HypPointT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> HypLineT<i128> {
+        HypLineT::new([self.coord[0], self.coord[1], -self.coord[2]])
+    }
+}
 
-impl CKPlane<HypPoint, i128> for HypLine {}
+impl HypLineT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> HypPointT<i128> {
+        HypPointT::new([self.coord[0], self.coord[1], -self.coord[2]])
+    }
+}
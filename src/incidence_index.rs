@@ -0,0 +1,193 @@
+// Incidence index over a point set
+//
+// Every pair of distinct points is joined once and the resulting line is
+// hashed in its canonical form (see `normalize_coord`), so that all points
+// on a common line end up in the same bucket. After that, asking for the
+// points on a line spanned by indexed points is a single hash lookup, and
+// collinear triples are read off the buckets directly. Building the index
+// costs O(N^2) joins and memory; each insert costs O(N).
+
+use crate::pg_plane::ProjPlanePrim;
+use core::hash::Hash;
+use std::collections::HashMap;
+
+#[derive(Debug, Clone)]
+pub struct IncidenceIndex<P, L> {
+    points: Vec<P>,
+    ids: Vec<usize>,
+    lookup: HashMap<P, usize>,
+    lines: HashMap<L, Vec<usize>>,
+}
+
+impl<P, L> Default for IncidenceIndex<P, L> {
+    fn default() -> Self {
+        Self {
+            points: Vec::new(),
+            ids: Vec::new(),
+            lookup: HashMap::new(),
+            lines: HashMap::new(),
+        }
+    }
+}
+
+impl<P, L> IncidenceIndex<P, L>
+where
+    P: ProjPlanePrim<L> + Hash + Clone,
+    L: ProjPlanePrim<P> + Hash,
+{
+    #[inline]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    pub fn from_slice(pts: &[P]) -> Self {
+        let mut res = Self::new();
+        for p in pts {
+            res.insert(p.clone());
+        }
+        res
+    }
+
+    /**
+    Insert a point and return its id
+
+    Projectively equal points share the same id.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::{IncidenceIndex, PgLine, PgPoint};
+    let mut index = IncidenceIndex::<PgPoint, PgLine>::new();
+    assert_eq!(index.insert(PgPoint::new([1, 2, 1])), 0);
+    assert_eq!(index.insert(PgPoint::new([3, 1, 1])), 1);
+    assert_eq!(index.insert(PgPoint::new([-2, -4, -2])), 0);
+    assert_eq!(index.len(), 2);
+    ```
+    */
+    pub fn insert(&mut self, p: P) -> usize {
+        if let Some(id) = self.lookup.get(&p) {
+            return *id;
+        }
+        let id = self.points.len();
+        for (i, q) in self.points.iter().enumerate() {
+            let ids = self.lines.entry(q.circ(&p)).or_insert_with(|| vec![i]);
+            // several earlier points may span the same line with `p`
+            if ids.last() != Some(&id) {
+                ids.push(id);
+            }
+        }
+        self.lookup.insert(p.clone(), id);
+        self.points.push(p);
+        self.ids.push(id);
+        id
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.points.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.points.is_empty()
+    }
+
+    #[inline]
+    pub fn point(&self, id: usize) -> &P {
+        &self.points[id]
+    }
+
+    #[inline]
+    pub fn id_of(&self, p: &P) -> Option<usize> {
+        self.lookup.get(p).copied()
+    }
+
+    /**
+    Ids of all indexed points on `line`, in increasing order
+
+    Lines through two or more indexed points are answered by a hash lookup;
+    any other line holds at most one point, which is found by a scan.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::{IncidenceIndex, PgLine, PgPoint};
+    let index = IncidenceIndex::<PgPoint, PgLine>::from_slice(&[
+        PgPoint::new([0, 0, 1]),
+        PgPoint::new([1, 1, 1]),
+        PgPoint::new([1, 0, 1]),
+        PgPoint::new([2, 2, 1]),
+    ]);
+    assert_eq!(index.points_on(&PgLine::new([1, -1, 0])), [0, 1, 3]);
+    assert_eq!(index.points_on(&PgLine::new([1, 0, -1])), [1, 2]);
+    assert_eq!(index.points_on(&PgLine::new([0, 1, 1])), [] as [usize; 0]);
+    ```
+    */
+    pub fn points_on(&self, line: &L) -> &[usize] {
+        if let Some(ids) = self.lines.get(line) {
+            return ids;
+        }
+        match self.points.iter().position(|p| p.incident(line)) {
+            Some(id) => &self.ids[id..=id],
+            None => &[],
+        }
+    }
+
+    /// Whether the indexed points `a`, `b` and `c` are collinear
+    pub fn coincident(&self, a: usize, b: usize, c: usize) -> bool {
+        if a == b || b == c || a == c {
+            return true;
+        }
+        self.lines[&self.points[a].circ(&self.points[b])]
+            .binary_search(&c)
+            .is_ok()
+    }
+
+    /// Lines through at least three indexed points, with the ids on each
+    pub fn collinear(&self) -> impl Iterator<Item = (&L, &[usize])> {
+        self.lines
+            .iter()
+            .filter(|(_, ids)| ids.len() >= 3)
+            .map(|(l, ids)| (l, ids.as_slice()))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_object::{PgLine, PgPoint};
+
+    #[test]
+    fn test_incidence_index() {
+        let mut index = IncidenceIndex::<PgPoint, PgLine>::new();
+        let grid: Vec<PgPoint> = (0..25).map(|i| PgPoint::new([i % 5, i / 5, 1])).collect();
+        for (i, p) in grid.iter().enumerate() {
+            assert_eq!(index.insert(*p), i);
+        }
+        assert_eq!(index.insert(PgPoint::new([8, 4, 2])), 14);
+
+        let lines = [
+            PgLine::new([1, -1, 0]),
+            PgLine::new([0, 1, -2]),
+            PgLine::new([2, -1, -1]),
+            PgLine::new([1, 1, -9]),
+            PgLine::new([7, 3, -100]),
+            PgLine::new([0, 0, 1]),
+        ];
+        for l in &lines {
+            let scan: Vec<usize> = (0..grid.len()).filter(|i| grid[*i].incident(l)).collect();
+            assert_eq!(index.points_on(l), scan.as_slice());
+        }
+        assert_eq!(index.points_on(&PgLine::new([-2, 2, 0])).len(), 5);
+
+        assert!(index.coincident(0, 6, 24));
+        assert!(!index.coincident(0, 6, 23));
+        assert_eq!(
+            index.collinear().filter(|(_, ids)| ids.len() == 5).count(),
+            12
+        );
+        for (l, ids) in index.collinear() {
+            assert!(ids.iter().all(|i| index.point(*i).incident(l)));
+        }
+    }
+}
@@ -0,0 +1,311 @@
+// All-pairs intersection of a line set
+//
+// Every pair of distinct lines is met once, in square tiles of `TILE` lines
+// so that both operands of the inner loop stay in cache. `visit_meets`
+// streams the meets to a callback; `Intersections` collects them in a hash
+// map keyed by the canonical form of the point (see `normalize_coord`), so
+// that all pairs through a common point land in the same bucket and the
+// bucket lists the concurrent lines. With the `parallel` feature,
+// `Intersections::par_from_lines` meets the tile rows on the rayon pool and
+// merges the per-row maps.
+//
+// Coincident lines have no meet and are skipped. Building costs O(N^2)
+// meets and O(N^2) memory in the worst case (no three lines concurrent);
+// buckets are compacted as they grow, so a point on k lines holds O(k) ids.
+
+use crate::pg_plane::ProjPlanePrim;
+use core::hash::Hash;
+use std::collections::HashMap;
+
+/// Lines per tile edge
+pub const TILE: usize = 128;
+
+/// Meet the pairs `(i, j)`, `i < j`, of the tile row starting at `bi`
+#[inline]
+fn visit_row<L, P, F>(lines: &[L], tile: usize, bi: usize, f: &mut F)
+where
+    L: ProjPlanePrim<P>,
+    F: FnMut(usize, usize, P),
+{
+    let n = lines.len();
+    let ei = (bi + tile).min(n);
+    for bj in (bi..n).step_by(tile) {
+        let ej = (bj + tile).min(n);
+        for i in bi..ei {
+            let l = &lines[i];
+            for j in bj.max(i + 1)..ej {
+                let m = &lines[j];
+                if l != m {
+                    f(i, j, l.circ(m));
+                }
+            }
+        }
+    }
+}
+
+/**
+Call `f(i, j, lines[i].circ(&lines[j]))` for every pair `i < j` of distinct lines
+
+Pairs are visited tile by tile, not in lexicographic order.
+
+Examples:
+
+```rust
+use projgeom_rs::intersections::visit_meets;
+use projgeom_rs::{PgLine, PgPoint};
+let lines = [[1, 0, 0], [0, 1, 0], [1, 1, 0], [0, 1, 0]].map(PgLine::new);
+let mut count = 0;
+visit_meets(&lines, 2, |_, _, p: PgPoint| {
+    assert_eq!(p, PgPoint::new([0, 0, 1]));
+    count += 1;
+});
+assert_eq!(count, 5); // the pair of equal lines is skipped
+```
+*/
+pub fn visit_meets<L, P, F>(lines: &[L], tile: usize, mut f: F)
+where
+    L: ProjPlanePrim<P>,
+    F: FnMut(usize, usize, P),
+{
+    assert!(tile > 0);
+    for bi in (0..lines.len()).step_by(tile) {
+        visit_row(lines, tile, bi, &mut f);
+    }
+}
+
+/// Intersection points of a line set, with the lines through each
+#[derive(Debug, Clone)]
+pub struct Intersections<P> {
+    points: HashMap<P, Vec<usize>>,
+}
+
+/// Sort and dedup `ids` if pushing `extra` more would reallocate
+///
+/// A bucket is compacted each time it fills its capacity and only grows when
+/// more than half of it survives, so it holds O(k) ids for k lines through
+/// its point rather than the k(k-1) of one push per pair end, at amortized
+/// O(log k) per push.
+#[inline]
+fn reserve_compact(ids: &mut Vec<usize>, extra: usize) {
+    if ids.len() + extra > ids.capacity() {
+        ids.sort_unstable();
+        ids.dedup();
+    }
+}
+
+#[inline]
+fn insert<P: Hash + Eq>(points: &mut HashMap<P, Vec<usize>>, i: usize, j: usize, p: P) {
+    let ids = points.entry(p).or_default();
+    reserve_compact(ids, 2);
+    ids.push(i);
+    ids.push(j);
+}
+
+/// Sort and dedup every bucket
+fn finish<P>(mut points: HashMap<P, Vec<usize>>) -> HashMap<P, Vec<usize>> {
+    for ids in points.values_mut() {
+        ids.sort_unstable();
+        ids.dedup();
+    }
+    points
+}
+
+impl<P: Hash + Eq> Intersections<P> {
+    /**
+    Meet every pair of `lines`
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::intersections::Intersections;
+    use projgeom_rs::{PgLine, PgPoint};
+    // three lines through the origin and one more
+    let lines = [[1, 0, 0], [0, 1, 0], [1, 1, 0], [1, 2, -4]].map(PgLine::new);
+    let xs = Intersections::<PgPoint>::from_lines(&lines);
+    assert_eq!(xs.len(), 4);
+    assert_eq!(xs.lines_through(&PgPoint::new([0, 0, 5])), Some(&[0, 1, 2][..]));
+    assert_eq!(xs.concurrent().count(), 1);
+    ```
+    */
+    pub fn from_lines<L>(lines: &[L]) -> Self
+    where
+        L: ProjPlanePrim<P>,
+    {
+        Self::from_lines_tiled(lines, TILE)
+    }
+
+    pub fn from_lines_tiled<L>(lines: &[L], tile: usize) -> Self
+    where
+        L: ProjPlanePrim<P>,
+    {
+        let mut points = HashMap::new();
+        visit_meets(lines, tile, |i, j, p| insert(&mut points, i, j, p));
+        Self {
+            points: finish(points),
+        }
+    }
+
+    /// Number of distinct intersection points
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.points.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.points.is_empty()
+    }
+
+    /// Ids of the lines through `p`, in increasing order, if `p` is an intersection point
+    #[inline]
+    pub fn lines_through(&self, p: &P) -> Option<&[usize]> {
+        self.points.get(p).map(|ids| ids.as_slice())
+    }
+
+    /// Number of lines through `p` (0 if it is not an intersection point)
+    #[inline]
+    pub fn multiplicity(&self, p: &P) -> usize {
+        self.points.get(p).map_or(0, |ids| ids.len())
+    }
+
+    /// All intersection points with the lines through each
+    #[inline]
+    pub fn iter(&self) -> impl Iterator<Item = (&P, &[usize])> {
+        self.points.iter().map(|(p, ids)| (p, ids.as_slice()))
+    }
+
+    /// Points with three or more lines through them
+    #[inline]
+    pub fn concurrent(&self) -> impl Iterator<Item = (&P, &[usize])> {
+        self.iter().filter(|(_, ids)| ids.len() >= 3)
+    }
+}
+
+#[cfg(feature = "parallel")]
+impl<P: Hash + Eq + Send> Intersections<P> {
+    /// `from_lines` with the tile rows met on the rayon pool
+    pub fn par_from_lines<L>(lines: &[L]) -> Self
+    where
+        L: ProjPlanePrim<P> + Sync,
+    {
+        use rayon::prelude::*;
+        let rows: Vec<usize> = (0..lines.len()).step_by(TILE).collect();
+        let points = rows
+            .into_par_iter()
+            .map(|bi| {
+                let mut points = HashMap::new();
+                visit_row(lines, TILE, bi, &mut |i, j, p| insert(&mut points, i, j, p));
+                points
+            })
+            // merge the smaller map into the larger one
+            .reduce(HashMap::new, |a, b| {
+                if a.len() < b.len() {
+                    merge(b, a)
+                } else {
+                    merge(a, b)
+                }
+            });
+        Self {
+            points: finish(points),
+        }
+    }
+}
+
+#[cfg(feature = "parallel")]
+fn merge<P: Hash + Eq>(
+    mut acc: HashMap<P, Vec<usize>>,
+    part: HashMap<P, Vec<usize>>,
+) -> HashMap<P, Vec<usize>> {
+    for (p, ids) in part {
+        let acc_ids = acc.entry(p).or_default();
+        reserve_compact(acc_ids, ids.len());
+        acc_ids.extend(ids);
+    }
+    acc
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_object::{HypLine, HypPoint};
+
+    /// Lines through the points of a small grid
+    fn pencil_lines() -> Vec<HypLine> {
+        let mut res = Vec::new();
+        for c in [[0, 0, 1], [3, 1, 1], [-2, 5, 1]] {
+            let p = HypPoint::new(c);
+            for d in 0..5 {
+                let q = HypPoint::new([d - 2, 2 * d + 1, 1]);
+                if q != p {
+                    res.push(p.circ(&q));
+                }
+            }
+        }
+        res
+    }
+
+    #[test]
+    fn test_bucket_compaction() {
+        // every pair of k concurrent lines lands in one bucket
+        let k = 300;
+        let mut points = HashMap::new();
+        for i in 0..k {
+            for j in (i + 1)..k {
+                insert(&mut points, i, j, ());
+                assert!(points[&()].len() <= 4 * k);
+            }
+        }
+        let points = finish(points);
+        assert_eq!(points[&()], (0..k).collect::<Vec<_>>());
+    }
+
+    #[test]
+    fn test_intersections() {
+        let lines = pencil_lines();
+        let xs = Intersections::<HypPoint>::from_lines(&lines);
+        // compare with a brute force count of distinct meets
+        let mut meets: Vec<HypPoint> = Vec::new();
+        for i in 0..lines.len() {
+            for j in (i + 1)..lines.len() {
+                if lines[i] == lines[j] {
+                    continue;
+                }
+                let p = lines[i].circ(&lines[j]);
+                if !meets.contains(&p) {
+                    meets.push(p);
+                }
+            }
+        }
+        assert_eq!(xs.len(), meets.len());
+        for p in &meets {
+            let through: Vec<usize> = (0..lines.len()).filter(|i| lines[*i].incident(p)).collect();
+            assert_eq!(xs.lines_through(p), Some(through.as_slice()));
+            assert_eq!(xs.multiplicity(p), through.len());
+        }
+        // a pencil center has all 5 lines of its pencil through it
+        assert!(xs.multiplicity(&HypPoint::new([0, 0, 1])) >= 5);
+        assert!(xs.concurrent().all(|(_, ids)| ids.len() >= 3));
+
+        // any tiling gives the same result
+        for tile in [1, 3, 7] {
+            let t = Intersections::<HypPoint>::from_lines_tiled(&lines, tile);
+            assert_eq!(t.len(), xs.len());
+            for (p, ids) in xs.iter() {
+                assert_eq!(t.lines_through(p), Some(ids));
+            }
+        }
+
+        #[cfg(feature = "parallel")]
+        {
+            let many: Vec<HypLine> = (0..3 * TILE as i128)
+                .map(|i| HypLine::new([i % 13 - 6, i % 7 + 1, i % 5 - 2]))
+                .collect();
+            let seq = Intersections::<HypPoint>::from_lines(&many);
+            let par = Intersections::<HypPoint>::par_from_lines(&many);
+            assert_eq!(par.len(), seq.len());
+            for (p, ids) in seq.iter() {
+                assert_eq!(par.lines_through(p), Some(ids));
+            }
+        }
+    }
+}
@@ -1,25 +1,69 @@
+pub mod autotune;
 pub mod ck_plane;
+pub mod ck_polarity;
+pub mod construction;
 // pub mod hyperbolic;
 // pub mod elliptic;
 pub mod ell_object;
 pub mod euclid_object;
+pub mod homography;
+pub mod hybrid;
 pub mod hyp_object;
+pub mod incidence_index;
+pub mod intersections;
+pub mod metrics;
+pub mod modp;
 pub mod myck_object;
 pub mod persp_object;
+pub mod pg_batch;
+pub mod pg_io;
 pub mod pg_object;
+#[cfg(feature = "parallel")]
+pub mod pg_parallel;
 pub mod pg_plane;
+pub mod pg_space;
+pub mod pool;
+pub mod reduced;
+pub mod robust;
+pub mod verifier;
 
 pub use crate::ck_plane::*;
+pub use crate::ck_polarity::{PolarLine, PolarLineT, PolarPoint, PolarPointT, Polarity};
+pub use crate::pg_object::Scalar;
 pub use crate::pg_object::{EllLine, EllPoint};
+pub use crate::pg_object::{EllLineT, EllPointT};
 pub use crate::pg_object::{EuclidLine, EuclidPoint};
+pub use crate::pg_object::{EuclidLineT, EuclidPointT};
 pub use crate::pg_object::{HypLine, HypPoint};
+pub use crate::pg_object::{HypLineT, HypPointT};
 pub use crate::pg_object::{MyCKLine, MyCKPoint};
+pub use crate::pg_object::{MyCKLineT, MyCKPointT};
 pub use crate::pg_object::{PerspLine, PerspPoint};
+pub use crate::pg_object::{PerspLineT, PerspPointT};
 pub use crate::pg_object::{PgLine, PgPoint};
+pub use crate::pg_object::{PgLineT, PgPointT};
 pub use crate::pg_plane::*;
 
+pub use crate::pg_batch::{EllLineBatch, EllPointBatch};
+pub use crate::pg_batch::{EllLineBatchT, EllPointBatchT};
+pub use crate::pg_batch::{EuclidLineBatch, EuclidPointBatch};
+pub use crate::pg_batch::{EuclidLineBatchT, EuclidPointBatchT};
+pub use crate::pg_batch::{HypLineBatch, HypPointBatch};
+pub use crate::pg_batch::{HypLineBatchT, HypPointBatchT};
+pub use crate::pg_batch::{MyCKLineBatch, MyCKPointBatch};
+pub use crate::pg_batch::{MyCKLineBatchT, MyCKPointBatchT};
+pub use crate::pg_batch::{PerspLineBatch, PerspPointBatch};
+pub use crate::pg_batch::{PerspLineBatchT, PerspPointBatchT};
+pub use crate::pg_batch::{PgLineBatch, PgPointBatch};
+pub use crate::pg_batch::{PgLineBatchT, PgPointBatchT};
+
 pub mod fractions;
-pub use crate::fractions::Fraction;
+pub use crate::fractions::{Fraction, FractionVec, LazyFraction};
+pub use crate::homography::Homography;
+pub use crate::hybrid::Hybrid;
+pub use crate::incidence_index::IncidenceIndex;
+pub use crate::modp::{Mod61, ModP, MultiModP};
+pub use crate::reduced::Reduced;
 
 #[cfg(test)]
 mod tests {
@@ -116,6 +160,114 @@ mod tests {
         assert_eq!(f + 2, Fraction::new(11, 4));
     }
 
+    #[test]
+    fn test_binary_gcd() {
+        use crate::fractions::binary_gcd;
+        for a in -40i64..40 {
+            for b in -40i64..40 {
+                assert_eq!(binary_gcd(a, b), gcd(a, b));
+            }
+        }
+        assert_eq!(binary_gcd(3i128 << 100, 6i128 << 90), 3 << 91);
+    }
+
+    #[test]
+    fn test_cmp_continued_fraction() {
+        let fs = [
+            Fraction::new(-7, 3),
+            Fraction::new(-2, 1),
+            Fraction::new(-5, 8),
+            Fraction::new(0, 1),
+            Fraction::new(21, 34),
+            Fraction::new(13, 21),
+            Fraction::new(5, 8),
+            Fraction::new(1, 1),
+            Fraction::new(22, 7),
+            Fraction::new(i64::MAX, 3),
+        ];
+        for (i, f) in fs.iter().enumerate() {
+            for (j, g) in fs.iter().enumerate() {
+                assert_eq!(f.cmp(g), i.cmp(&j));
+            }
+        }
+    }
+
+    #[test]
+    fn test_lazy_fraction() {
+        use crate::fractions::LazyFraction;
+        let mut f = Fraction::new(0, 1);
+        let mut g = LazyFraction::new(0, 1);
+        for k in 1..40i64 {
+            let h = Fraction::new(if k % 3 == 0 { -1 } else { 1 }, k * (k + 1));
+            f += h;
+            g += LazyFraction::from(h);
+            assert_eq!(g.to_fraction(), f);
+        }
+        let h = LazyFraction::new(3, -4);
+        assert_eq!((g * h / h).to_fraction(), f);
+        assert!(g - h > g);
+        assert_eq!(h.to_string(), "(-3/4)");
+    }
+
+    #[test]
+    fn test_fraction_vec() {
+        let fs: Vec<Fraction<i64>> = (1..50i64)
+            .map(|k| Fraction::new(k % 7 - 3, k % 5 + 1))
+            .collect();
+        let gs: Vec<Fraction<i64>> = (1..50i64).map(|k| Fraction::new(k % 4 - 1, 12)).collect();
+        let (mut a, b) = (
+            FractionVec::from_fractions(&fs),
+            FractionVec::from_fractions(&gs),
+        );
+        assert_eq!(a.to_vec(), fs);
+        a += &b;
+        a += &b; // same denominator from here on
+        a -= &b;
+        a *= &b;
+        a *= Fraction::new(-2, 3);
+        let expect: Vec<_> = fs
+            .iter()
+            .zip(&gs)
+            .map(|(f, g)| (*f + *g) * *g * Fraction::new(-2, 3))
+            .collect();
+        assert_eq!(a.to_vec(), expect);
+        let order: Vec<_> = expect.iter().zip(&gs).map(|(e, g)| e.cmp(g)).collect();
+        assert_eq!(a.cmp_many(&b), order);
+        let half = Fraction::new(1, 2);
+        assert_eq!(
+            a.cmp_with(&half),
+            expect.iter().map(|e| e.cmp(&half)).collect::<Vec<_>>()
+        );
+        assert_eq!(a, FractionVec::from_fractions(&expect));
+
+        // long sums stay bounded by the deferred reductions
+        let mut sum = FractionVec::from_integers(vec![0i64; 3]);
+        for k in 1..200i64 {
+            sum += &FractionVec::new(vec![1, -1, 2], k * (k + 1));
+        }
+        assert_eq!(sum.get(0), Fraction::new(199, 200));
+        assert_eq!(sum.get(2), Fraction::new(199, 100));
+
+        // coprime entries past half width stay large after `reduce`
+        let (p, q) = ((1i64 << 40) + 1, (1i64 << 40) - 1);
+        let wide = FractionVec::new(vec![p - 2, p, p + 2, i64::MIN + 1], q);
+        let near = FractionVec::new(vec![p, p, p, -1], q + 2);
+        let near_f = near.to_vec();
+        let order: Vec<_> = wide
+            .to_vec()
+            .iter()
+            .zip(&near_f)
+            .map(|(w, n)| w.cmp(n))
+            .collect();
+        assert_eq!(wide.cmp_many(&near), order);
+        let with: Vec<_> = wide.to_vec().iter().map(|w| w.cmp(&near_f[0])).collect();
+        assert_eq!(wide.cmp_with(&near_f[0]), with);
+        assert_ne!(wide, near);
+        let same = FractionVec::new(vec![(p - 2) * 3, p * 3, (p + 2) * 3, 0], q * 3);
+        assert_eq!(same.numerators()[..3], [p - 2, p, p + 2]); // reduced
+        assert_eq!(FractionVec::new(vec![i64::MIN], 1).denominator(), 1);
+    }
+
     #[test]
     fn test_special() {
         let zero = Fraction::new(0, 1);
@@ -171,10 +323,11 @@ mod tests {
         check_pg_plane(p, q);
     }
 
-    fn check_ck_plane<P, L>(a1: P, a2: P, a3: P)
+    fn check_ck_plane<P, L, V>(a1: P, a2: P, a3: P)
     where
-        P: CKPlane<L, i128> + std::fmt::Debug,
-        L: CKPlane<P, i128> + std::fmt::Debug,
+        V: Default + PartialEq,
+        P: CKPlane<L, V> + std::fmt::Debug,
+        L: CKPlane<P, V> + std::fmt::Debug,
     {
         let triangle = [a1, a2, a3];
         let trilateral = tri_dual(&triangle);
@@ -259,6 +412,255 @@ mod tests {
         check_ck_plane(a1, a2, a3);
     }
 
+    #[test]
+    fn test_measurements() {
+        // Pythagoras: q1 = q2 + q3 - q2 q3 with the right angle at a1
+        fn check_pythagoras<P, L>(a1: P, a2: P, other: L)
+        where
+            P: CKPlane<L, i128> + Clone + std::fmt::Debug,
+            L: CKPlane<P, i128> + Clone + std::fmt::Debug,
+        {
+            let t = altitude(&a1, &a1.circ(&a2));
+            let a3 = t.circ(&other);
+            let q1: Fraction<i128> = quadrance(&a2, &a3);
+            let q2: Fraction<i128> = quadrance(&a1, &a3);
+            let q3: Fraction<i128> = quadrance(&a1, &a2);
+            assert_eq!(q1, q2 + q3 - q2 * q3);
+            let s1: Fraction<i128> = spread(&a1.circ(&a2), &a1.circ(&a3));
+            assert_eq!(s1, Fraction::new(1, 1));
+            // the batch forms agree with the scalar one
+            let ps = [a1.clone(), a2.clone(), a3.clone()];
+            let m = quadrance_matrix(&ps);
+            let qs = quadrance_many(&ps, &[a2, a3.clone(), a1]);
+            assert_eq!(m[1], qs[0]);
+            assert_eq!(m[1 * 3 + 2], qs[1]);
+            assert_eq!(m[2 * 3 + 0], qs[2]);
+            assert_eq!(Fraction::new(m[5].0, m[5].1), q1);
+        }
+        check_pythagoras(
+            EllPoint::new([1, 3, 2]),
+            EllPoint::new([-2, 1, 3]),
+            EllLine::new([4, -3, 5]),
+        );
+        check_pythagoras(
+            HypPoint::new([1, 3, 7]),
+            HypPoint::new([-2, 1, 5]),
+            HypLine::new([4, -3, 5]),
+        );
+        check_pythagoras(
+            MyCKPoint::new([1, 3, 7]),
+            MyCKPoint::new([-2, 1, 5]),
+            MyCKLine::new([4, -3, 5]),
+        );
+
+        // the cross ratio is projectively invariant
+        let (a, b) = (PgPoint::new([1, 3, 2]), PgPoint::new([-2, 1, -1]));
+        let (c, d) = (a.plucker(&2, &b, &5), a.plucker(&-3, &b, &1));
+        let (num, den) = cross_ratio(&a, &b, &c, &d);
+        let h = homography::Homography::new([[2, 1, 0], [0, 1, 3], [1, 0, 1]]);
+        let (num2, den2) = cross_ratio(&h.apply(&a), &h.apply(&b), &h.apply(&c), &h.apply(&d));
+        assert_eq!(num * den2, num2 * den);
+        // (a, b; c, d) = (mu_c / ld_c) / (mu_d / ld_d) for c = ld a + mu b
+        assert_eq!(Fraction::new(num, den), Fraction::new(5 * -3, 2 * 1));
+
+        // 20-bit coordinates: the determinants are only of degree 2
+        let (a, b) = (
+            PgPoint::new([1 << 20, 3 << 19, (1 << 20) - 7]),
+            PgPoint::new([-(5 << 18), 1 << 20, -(1 << 19) + 3]),
+        );
+        let (c, d) = (a.plucker(&2, &b, &5), a.plucker(&-3, &b, &1));
+        let (num, den) = cross_ratio(&a, &b, &c, &d);
+        assert_eq!(Fraction::new(num, den), Fraction::new(-15, 2));
+        let [a, b, c, d] = [a, b, c, d].map(|p| PgPointT::new(p.coord.map(Mod61::new)));
+        let (num, den) = cross_ratio(&a, &b, &c, &d);
+        assert_ne!(den, Mod61::ZERO);
+        assert_eq!(num * Mod61::new(2), den * Mod61::new(-15));
+    }
+
+    #[test]
+    fn test_affine_point() {
+        use crate::euclid_object::{try_affine_orthocenter, AffinePoint};
+        let coords = [[13, 23], [44, -34], [-2, 12], [7, 5]];
+        let pts = coords.map(AffinePoint::new);
+        let hpts = pts.map(EuclidPoint::from);
+        for i in 0..4 {
+            assert_eq!(hpts[i].to_affine(), Some(pts[i]));
+            for j in 0..4 {
+                if i == j {
+                    continue;
+                }
+                let (l, hl) = (pts[i].circ(&pts[j]), hpts[i].circ(&hpts[j]));
+                assert_eq!(l, hl);
+                assert!(pts[i].incident(&l) && pts[j].incident(&l));
+                assert_eq!(pts[i].midpoint(&pts[j]), hpts[i].midpoint(&hpts[j]));
+                assert_eq!(pts[i].altitude(&l), l.altitude(&hpts[i]));
+                let (seg1, seg2) = ([pts[i], pts[j]], [pts[(i + 1) % 4], pts[(i + 2) % 4]]);
+                let hl2 = hpts[(i + 1) % 4].circ(&hpts[(i + 2) % 4]);
+                assert_eq!(AffinePoint::is_parallel(&seg1, &seg2), hl.is_parallel(&hl2));
+                assert_eq!(
+                    AffinePoint::is_perpendicular(&seg1, &seg2),
+                    hl.is_perpendicular(&hl2)
+                );
+            }
+        }
+        let tri = [pts[0], pts[1], pts[2]];
+        assert_eq!(
+            try_affine_orthocenter(&tri),
+            euclid_object::try_orthocenter(&tri.map(EuclidPoint::from))
+        );
+        let seg = [AffinePoint::new([0, 0]), AffinePoint::new([2, 1])];
+        let perp = [AffinePoint::new([5, 5]), AffinePoint::new([4, 7])];
+        assert!(AffinePoint::is_perpendicular(&seg, &perp));
+        assert!(AffinePoint::is_parallel(
+            &seg,
+            &[perp[0], AffinePoint::new([9, 7])]
+        ));
+        assert_eq!(
+            EuclidPoint::new([4, -6, 2]).to_affine(),
+            Some(AffinePoint::new([2, -3]))
+        );
+        assert_eq!(EuclidPoint::new([4, -5, 2]).to_affine(), None);
+        assert_eq!(EuclidPoint::new([4, -5, 0]).to_affine(), None);
+    }
+
+    #[test]
+    fn test_scalar_variants() {
+        let p = PgPointT::<i64>::new([1, 3, 2]);
+        let q = PgPointT::<i64>::new([-2, 1, -1]);
+        let l = p.circ(&q);
+        assert_eq!(l, PgLineT::new([-5, -3, 7]));
+        assert!(l.incident(&p.plucker(&2, &q, &3)));
+
+        let a1 = HypPointT::<i64>::new([13, 23, 32]);
+        let a2 = HypPointT::<i64>::new([44, -34, 2]);
+        let a3 = HypPointT::<i64>::new([-2, 12, 23]);
+        check_ck_plane(a1, a2, a3);
+
+        let a1 = EllPointT::<f64>::new([13.0, 23.0, 32.0]);
+        let a2 = EllPointT::<f64>::new([44.0, -34.0, 2.0]);
+        let a3 = EllPointT::<f64>::new([-2.0, 12.0, 23.0]);
+        check_ck_plane(a1, a2, a3);
+    }
+
+    #[test]
+    fn test_const_construction() {
+        const A: HypPoint = HypPoint::new([13, 23, 32]);
+        const B: HypPoint = HypPoint::new([44, -34, 2]);
+        const L: HypLine = A.circ_const(&B);
+        const C: HypPoint = A.plucker_const(3, &B, -5);
+        const POLE: HypPoint = L.perp_const();
+        const _: () = assert!(C.incident_const(&L));
+        assert_eq!(L, A.circ(&B));
+        assert_eq!(C, A.plucker(&3, &B, &-5));
+        assert_eq!(POLE, L.perp());
+
+        const M: MyCKLine = MyCKLine::new([3, -1, 7]);
+        assert_eq!(M.perp_const(), M.perp());
+        assert_eq!(M.perp_const().perp_const(), M.perp().perp());
+        const E: EuclidLine = EuclidLine::new([3, -1, 7]);
+        assert_eq!(E.perp_const(), E.perp());
+        assert_eq!(EllLine::new([3, -1, 7]).perp_const().coord, [3, -1, 7]);
+    }
+
+    #[test]
+    fn test_checked_variants() {
+        let tri = [[13, 23, 32], [44, -34, 2], [-2, 12, 23]].map(HypPoint::new);
+        let flat = [[1, 3, 2], [-2, 1, -1], [1, 3, 2]].map(HypPoint::new);
+        assert_eq!(try_orthocenter(&tri), Some(orthocenter(&tri)));
+        assert_eq!(orthocenter_unchecked(&tri), orthocenter(&tri));
+        assert_eq!(try_tri_altitude(&tri), Some(tri_altitude(&tri)));
+        assert_eq!(tri_altitude_unchecked(&tri), tri_altitude(&tri));
+        assert_eq!(tri_dual_unchecked(&tri), tri_dual::<_, HypLine>(&tri));
+        assert_eq!(try_orthocenter(&flat), None);
+        assert_eq!(try_tri_altitude::<_, HypLine>(&flat), None);
+
+        let etri = tri.map(|p| EuclidPoint::new(p.coord));
+        assert_eq!(
+            euclid_object::try_orthocenter(&etri),
+            Some(euclid_object::orthocenter_unchecked(&etri))
+        );
+        assert_eq!(
+            euclid_object::try_tri_altitude(&etri),
+            Some(euclid_object::tri_altitude_unchecked(&etri))
+        );
+        assert_eq!(
+            euclid_object::try_orthocenter(&flat.map(|p| EuclidPoint::new(p.coord))),
+            None
+        );
+
+        let (p, q) = (PgPoint::new([1, 3, 2]), PgPoint::new([-2, 1, -1]));
+        let c = p.plucker(&2, &q, &5);
+        assert_eq!(try_harm_conj(&p, &q, &c), Some(harm_conj(&p, &q, &c)));
+        assert_eq!(harm_conj_unchecked(&p, &q, &c), harm_conj(&p, &q, &c));
+        assert_eq!(try_harm_conj(&p, &q, &PgPoint::new([4, -3, 5])), None);
+    }
+
+    /// The fused overrides against the object-level construction
+    fn check_fused<P, L>(coords: [[i128; 3]; 3], new: fn([i128; 3]) -> P)
+    where
+        P: CKPlanePrim<L> + core::fmt::Debug,
+        L: CKPlanePrim<P> + core::fmt::Debug,
+    {
+        let tri = coords.map(new);
+        let [a1, a2, a3] = &tri;
+        let sides: [L; 3] = [a2.circ(a3), a1.circ(a3), a1.circ(a2)];
+        let alts = [0, 1, 2].map(|i| altitude(&tri[i], &sides[i]));
+        assert_eq!(tri_altitude(&tri), alts);
+        assert_eq!(tri_altitude_unchecked(&tri), alts);
+        assert_eq!(orthocenter(&tri), alts[0].circ(&alts[1]));
+        assert_eq!(orthocenter_unchecked(&tri), orthocenter(&tri));
+        let flat = [coords[0], coords[1], coords[0]].map(new);
+        assert_eq!(try_orthocenter(&flat), None);
+        assert_eq!(try_tri_altitude(&flat), None);
+    }
+
+    #[test]
+    fn test_fused_triangle_kernels() {
+        let coords = [[13, 23, 32], [44, -34, 2], [-2, 12, 23]];
+        check_fused::<_, HypLine>(coords, HypPoint::new);
+        check_fused::<_, HypPoint>(coords, HypLine::new);
+        check_fused::<_, EllLine>(coords, EllPoint::new);
+        check_fused::<_, EllPoint>(coords, EllLine::new);
+        check_fused::<_, MyCKLine>(coords, MyCKPoint::new);
+        check_fused::<_, MyCKPoint>(coords, MyCKLine::new);
+        check_fused::<_, PerspLine>(coords, PerspPoint::new);
+        check_fused::<_, EuclidLine>(coords, EuclidPoint::new);
+        check_fused::<_, PolarLine<ck_polarity::MyCKPolarity>>(coords, PolarPoint::new);
+        check_fused::<_, PolarPoint<ck_polarity::MyCKPolarity>>(coords, PolarLine::new);
+    }
+
+    #[test]
+    #[should_panic(expected = "degenerate triangle")]
+    fn test_orthocenter_degenerate() {
+        orthocenter(&[[0, 0, 1], [1, 1, 1], [2, 2, 1]].map(HypPoint::new));
+    }
+
+    #[test]
+    fn test_eq_hash() {
+        use std::collections::HashSet;
+        let p = PgPoint::new([1, 3, 2]);
+        assert_eq!(p, PgPoint::new([-2, -6, -4]));
+        assert_ne!(p, PgPoint::new([1, 3, 3]));
+        assert_ne!(p, PgPoint::new([2, 3, 2]));
+        assert_ne!(PgPoint::new([0, 0, 1]), PgPoint::new([0, 1, 1]));
+
+        let lines = [
+            PgLine::new([1, 0, 0]),
+            PgLine::new([0, 1, 0]),
+            PgLine::new([1, 1, 0]),
+            PgLine::new([1, 0, -1]),
+        ];
+        let mut meets = HashSet::new();
+        for (i, l) in lines.iter().enumerate() {
+            for m in &lines[i + 1..] {
+                meets.insert(l.circ(m));
+            }
+        }
+        // the first three lines are concurrent at the origin
+        assert_eq!(meets.len(), 4);
+        assert!(meets.contains(&PgPoint::new([0, 0, -7])));
+    }
+
     #[quickcheck]
     fn test_pg_point_q(pz: i64, qz: i64) -> bool {
         let p = PgPoint::new([1, 3, pz.into()]);
@@ -0,0 +1,360 @@
+// Operation counters and coordinate magnitude histograms (feature `metrics`)
+//
+// Every thread owns a block of counters that only it writes, so counting
+// is a relaxed load and store with no locked instruction and no contention.
+// The blocks are registered in a global list, which is how `snapshot` sums
+// them on demand; when a thread exits its block is folded into a retired
+// total and unregistered, so counts are not lost and the list only holds
+// running threads. `reset` records a base per block instead of zeroing it,
+// so it is safe while other threads count. The histogram buckets the bit length of the largest coordinate
+// of every constructed object (see `Scalar::bit_len`), which shows how close
+// a workload comes to overflowing its integer type.
+//
+// Without the feature, `count` and `record` are empty inline functions and
+// the instrumented code compiles exactly as before.
+
+use crate::pg_object::Scalar;
+
+/// Instrumented primitive operations
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum Op {
+    /// `circ`: join or meet
+    Circ = 0,
+    /// `incident`
+    Incident = 1,
+    /// `dot`: basic measurement
+    Dot = 2,
+    /// `plucker`
+    Plucker = 3,
+    /// `fractions::binary_gcd`
+    Gcd = 4,
+    /// `normalize_coord` (so `Normalize::normalize`, but not `Hash`) and the
+    /// `Fraction`/`LazyFraction` reductions
+    Normalize = 5,
+    /// `autotune::narrow_batch` built in i32
+    KernelI32 = 6,
+    /// `autotune::narrow_batch` built in i64
+    KernelI64 = 7,
+    /// `autotune::narrow_batch` built in i128
+    KernelI128 = 8,
+}
+
+pub const NUM_OPS: usize = 9;
+/// Histogram buckets: bit lengths 0 to 128
+pub const NUM_BUCKETS: usize = 129;
+
+#[cfg(feature = "metrics")]
+mod imp {
+    use super::{Op, Snapshot, NUM_BUCKETS, NUM_OPS};
+    use std::sync::atomic::{AtomicU64, Ordering::Relaxed};
+    use std::sync::{Arc, Mutex};
+
+    pub(super) struct Counters {
+        pub(super) ops: [AtomicU64; NUM_OPS],
+        pub(super) bits: [AtomicU64; NUM_BUCKETS],
+        /// Values of `ops` and `bits` at the last `reset`, written by the
+        /// resetting thread so the owner's counters are never stored to
+        /// from outside
+        pub(super) base_ops: [AtomicU64; NUM_OPS],
+        pub(super) base_bits: [AtomicU64; NUM_BUCKETS],
+    }
+
+    #[allow(clippy::declare_interior_mutable_const)]
+    const ZERO: AtomicU64 = AtomicU64::new(0);
+
+    impl Counters {
+        fn new() -> Self {
+            Self {
+                ops: [ZERO; NUM_OPS],
+                bits: [ZERO; NUM_BUCKETS],
+                base_ops: [ZERO; NUM_OPS],
+                base_bits: [ZERO; NUM_BUCKETS],
+            }
+        }
+
+        /// Add the counts since the last `reset` to `res`
+        pub(super) fn add_to(&self, res: &mut Snapshot) {
+            // the base is read first: it is an earlier value of the counter,
+            // so the difference cannot wrap
+            let since = |c: &AtomicU64, b: &AtomicU64| {
+                let b = b.load(Relaxed);
+                c.load(Relaxed) - b
+            };
+            for (t, (c, b)) in res.ops.iter_mut().zip(self.ops.iter().zip(&self.base_ops)) {
+                *t += since(c, b);
+            }
+            for (t, (c, b)) in res
+                .bits
+                .iter_mut()
+                .zip(self.bits.iter().zip(&self.base_bits))
+            {
+                *t += since(c, b);
+            }
+        }
+
+        pub(super) fn rebase(&self) {
+            let pairs = self.ops.iter().zip(&self.base_ops);
+            for (c, b) in pairs.chain(self.bits.iter().zip(&self.base_bits)) {
+                b.store(c.load(Relaxed), Relaxed);
+            }
+        }
+    }
+
+    /// Counters of the running threads, and the totals of the finished ones
+    pub(super) struct Registry {
+        pub(super) live: Vec<Arc<Counters>>,
+        pub(super) retired: Snapshot,
+    }
+
+    pub(super) static REGISTRY: Mutex<Registry> = Mutex::new(Registry {
+        live: Vec::new(),
+        retired: Snapshot {
+            ops: [0; NUM_OPS],
+            bits: [0; NUM_BUCKETS],
+        },
+    });
+
+    /// Per-thread counters; on thread exit they are folded into
+    /// `Registry::retired` and unregistered, so the registry does not grow
+    /// with the number of threads ever started
+    pub(super) struct Local(pub(super) Arc<Counters>);
+
+    impl Drop for Local {
+        fn drop(&mut self) {
+            let mut reg = REGISTRY.lock().unwrap_or_else(|e| e.into_inner());
+            let reg = &mut *reg;
+            self.0.add_to(&mut reg.retired);
+            reg.live.retain(|c| !Arc::ptr_eq(c, &self.0));
+        }
+    }
+
+    thread_local! {
+        pub(super) static LOCAL: Local = {
+            let counters = Arc::new(Counters::new());
+            REGISTRY.lock().unwrap().live.push(counters.clone());
+            Local(counters)
+        };
+    }
+
+    /// Single-writer increment: no read-modify-write needed
+    #[inline(always)]
+    fn bump(c: &AtomicU64, n: u64) {
+        c.store(c.load(Relaxed) + n, Relaxed);
+    }
+
+    // `try_with`: counting from another thread-local destructor is dropped
+    #[inline(always)]
+    pub(super) fn count(op: Op, n: u64) {
+        let _ = LOCAL.try_with(|c| bump(&c.0.ops[op as usize], n));
+    }
+
+    #[inline(always)]
+    pub(super) fn record_bits(bits: u32) {
+        let _ = LOCAL.try_with(|c| bump(&c.0.bits[(bits as usize).min(NUM_BUCKETS - 1)], 1));
+    }
+}
+
+/// Count one `op`
+#[inline(always)]
+pub(crate) fn count(op: Op) {
+    count_n(op, 1);
+}
+
+/// Count `n` of `op` at once, for fused kernels that stand for several
+#[inline(always)]
+pub(crate) fn count_n(op: Op, n: u64) {
+    #[cfg(feature = "metrics")]
+    imp::count(op, n);
+    #[cfg(not(feature = "metrics"))]
+    let _ = (op, n);
+}
+
+/// Record the magnitude of a constructed coordinate
+#[inline(always)]
+pub(crate) fn record<T: Scalar, const N: usize>(coord: &[T; N]) {
+    #[cfg(feature = "metrics")]
+    imp::record_bits(coord.iter().map(|c| c.bit_len()).max().unwrap_or(0));
+    #[cfg(not(feature = "metrics"))]
+    let _ = coord;
+}
+
+/// Totals of the counters
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Snapshot {
+    pub ops: [u64; NUM_OPS],
+    /// `bits[k]`: objects whose largest coordinate is `k` bits long
+    pub bits: [u64; NUM_BUCKETS],
+}
+
+impl Default for Snapshot {
+    fn default() -> Self {
+        Self {
+            ops: [0; NUM_OPS],
+            bits: [0; NUM_BUCKETS],
+        }
+    }
+}
+
+impl Snapshot {
+    #[inline]
+    pub fn count(&self, op: Op) -> u64 {
+        self.ops[op as usize]
+    }
+
+    /// Largest recorded bit length, `None` if nothing was recorded
+    pub fn max_bits(&self) -> Option<u32> {
+        self.bits.iter().rposition(|n| *n != 0).map(|k| k as u32)
+    }
+
+    /// Number of recorded objects with a coordinate longer than `bits`
+    pub fn above(&self, bits: u32) -> u64 {
+        self.bits.iter().skip(bits as usize + 1).sum()
+    }
+}
+
+/**
+Totals over all threads since the last `reset`
+
+Examples:
+
+```rust
+use projgeom_rs::metrics::{self, Op};
+use projgeom_rs::{PgLine, PgPoint, ProjPlanePrim};
+let before = metrics::local_snapshot();
+let l: PgLine = PgPoint::new([1, 3, 2]).circ(&PgPoint::new([-2, 1, -1]));
+let after = metrics::local_snapshot();
+assert_eq!(after.count(Op::Circ) - before.count(Op::Circ), 1);
+assert!(after.max_bits() >= Some(3));
+```
+*/
+#[cfg(feature = "metrics")]
+pub fn snapshot() -> Snapshot {
+    let reg = imp::REGISTRY.lock().unwrap();
+    let mut res = reg.retired.clone();
+    for c in reg.live.iter() {
+        c.add_to(&mut res);
+    }
+    res
+}
+
+/// Counters of the calling thread only
+///
+/// The difference of two local snapshots counts the operations in between,
+/// unless a `reset` from another thread lands there: it rebases this
+/// thread's counters too, so the later snapshot may even be the smaller.
+#[cfg(feature = "metrics")]
+pub fn local_snapshot() -> Snapshot {
+    let mut res = Snapshot::default();
+    let _ = imp::LOCAL.try_with(|c| c.0.add_to(&mut res));
+    res
+}
+
+/// Start every count over from zero
+///
+/// Safe while other threads are counting: a reset records each thread's
+/// current counts as its new base rather than storing to the counters, so
+/// no increment is lost or resurrected. It also restarts the counts of
+/// every live thread, so a `local_snapshot` difference taken across the
+/// reset is not monotonic.
+#[cfg(feature = "metrics")]
+pub fn reset() {
+    let mut reg = imp::REGISTRY.lock().unwrap();
+    reg.retired = Snapshot::default();
+    for c in reg.live.iter() {
+        c.rebase();
+    }
+}
+
+/// Serializes the tests that diff snapshots against `reset` in
+/// `test_aggregate_threads`; a poisoned lock is fine to reuse
+#[cfg(all(test, feature = "metrics"))]
+pub(crate) fn test_guard() -> std::sync::MutexGuard<'static, ()> {
+    static LOCK: std::sync::Mutex<()> = std::sync::Mutex::new(());
+    LOCK.lock().unwrap_or_else(|e| e.into_inner())
+}
+
+#[cfg(all(test, feature = "metrics"))]
+mod tests {
+    use super::*;
+    use crate::fractions::Fraction;
+    use crate::pg_object::{PgLine, PgPoint, PgPointT};
+    use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+
+    #[test]
+    fn test_local_counts() {
+        let _guard = test_guard();
+        let before = local_snapshot();
+        let (p, q) = (PgPoint::new([1, 3, 2]), PgPoint::new([-2, 1, -1]));
+        let l: PgLine = p.circ(&q);
+        assert!(l.incident(&p));
+        let r = p.plucker(&(1 << 70), &q, &1);
+        let _ = Fraction::new(30, -40);
+        let d = local_snapshot();
+        let diff = |op| d.count(op) - before.count(op);
+        assert_eq!(diff(Op::Circ), 1);
+        assert_eq!(diff(Op::Incident), 1);
+        assert_eq!(diff(Op::Plucker), 1);
+        assert!(diff(Op::Gcd) >= 1 && diff(Op::Normalize) >= 1);
+        assert_eq!(r.coord[0], (1 << 70) - 2);
+        assert!(d.above(70) > before.above(70));
+
+        // hashing the canonical form is not a counted normalization
+        let before = local_snapshot();
+        let set: std::collections::HashSet<PgPoint> = [p, q, r].into_iter().collect();
+        assert!(set.contains(&PgPoint::new([2, 6, 4])));
+        assert_eq!(
+            local_snapshot().count(Op::Normalize),
+            before.count(Op::Normalize)
+        );
+    }
+
+    #[test]
+    fn test_aggregate_threads() {
+        let _guard = test_guard();
+        let f = || {
+            let p = PgPointT::<i64>::new([1, 2, 3]);
+            for _ in 0..1000 {
+                let _ = p.dot(&p.aux());
+            }
+        };
+        std::thread::scope(|s| {
+            s.spawn(f);
+            s.spawn(f);
+        });
+        // the finished threads still count, but are no longer registered
+        assert!(snapshot().count(Op::Dot) >= 2000);
+        let live = imp::REGISTRY.lock().unwrap().live.len();
+        for _ in 0..50 {
+            std::thread::spawn(f).join().unwrap();
+        }
+        assert!(imp::REGISTRY.lock().unwrap().live.len() <= live);
+        assert!(snapshot().count(Op::Dot) >= 52_000);
+        check_reset_keeps_running_counts();
+    }
+
+    /// Part of `test_aggregate_threads`: a reset would break its totals
+    fn check_reset_keeps_running_counts() {
+        use std::sync::Barrier;
+        let (paused, resumed) = (Barrier::new(2), Barrier::new(2));
+        let p = PgPointT::<i64>::new([1, 2, 3]);
+        let after = std::thread::scope(|s| {
+            let t = s.spawn(|| {
+                (0..1000).for_each(|_| {
+                    let _ = p.dot(&p.aux());
+                });
+                paused.wait();
+                resumed.wait();
+                (0..500).for_each(|_| {
+                    let _ = p.dot(&p.aux());
+                });
+                local_snapshot().count(Op::Dot)
+            });
+            paused.wait();
+            reset();
+            resumed.wait();
+            t.join().unwrap()
+        });
+        // counting resumes from the reset, not from the old total
+        assert_eq!(after, 500);
+    }
+}
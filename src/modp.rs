@@ -0,0 +1,386 @@
+// Finite field scalars for exact yes/no predicates
+//
+// `ModP<P>` is an element of GF(P) kept in a single u64. Incidence tests
+// only ask whether some polynomial in the coordinates vanishes, which
+// survives reduction modulo P: a nonzero residue proves the integer value
+// is nonzero, while a zero residue is wrong only if P happens to divide the
+// value. `MultiModP` evaluates the same expression modulo three 61-bit
+// primes at once, so a false positive needs all three to divide it.
+//
+// Moduli of the form 2^61 - c with small c (2^61 - 1 included) use a
+// shift-and-fold reduction instead of a 128-bit division.
+
+use crate::pg_object::Scalar;
+use core::ops::{Add, Div, Mul, Neg, Rem, Sub};
+use num_traits::{Num, One, Zero};
+
+/// 2^61 - 1
+pub const MERSENNE61: u64 = (1 << 61) - 1;
+/// 2^61 - 31
+pub const PRIME61_B: u64 = (1 << 61) - 31;
+/// 2^61 - 45
+pub const PRIME61_C: u64 = (1 << 61) - 45;
+
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq, Hash)]
+pub struct ModP<const P: u64>(u64);
+
+pub type Mod61 = ModP<MERSENNE61>;
+
+impl<const P: u64> ModP<P> {
+    const VALID: () = assert!(P > 1 && P < 1 << 63, "ModP: modulus out of range");
+    const FOLD: u64 = (1u64 << 61).wrapping_sub(P);
+    const PSEUDO_MERSENNE: bool = P <= 1 << 61 && Self::FOLD < 64;
+
+    /**
+    Residue of an integer
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::modp::ModP;
+    assert_eq!(ModP::<7>::new(-3).value(), 4);
+    assert_eq!(ModP::<7>::new(7 * 12345 + 2).value(), 2);
+    ```
+    */
+    #[inline]
+    pub fn new(value: i128) -> Self {
+        #[allow(clippy::let_unit_value)]
+        let _ = Self::VALID;
+        Self(value.rem_euclid(P as i128) as u64)
+    }
+
+    /// Canonical representative in 0..P
+    #[inline]
+    pub fn value(&self) -> u64 {
+        self.0
+    }
+
+    #[inline]
+    fn mul_mod(a: u64, b: u64) -> u64 {
+        let t = a as u128 * b as u128;
+        if P == MERSENNE61 {
+            let r = (t as u64 & MERSENNE61) + (t >> 61) as u64;
+            if r >= P {
+                r - P
+            } else {
+                r
+            }
+        } else if Self::PSEUDO_MERSENNE {
+            // 2^61 = FOLD (mod P)
+            let r = (t >> 61) * Self::FOLD as u128 + (t as u64 & MERSENNE61) as u128;
+            let r = (r >> 61) as u64 * Self::FOLD + (r as u64 & MERSENNE61);
+            if r >= P {
+                r - P
+            } else {
+                r
+            }
+        } else {
+            (t % P as u128) as u64
+        }
+    }
+
+    /// `self^exp` by square-and-multiply
+    pub fn pow(self, mut exp: u64) -> Self {
+        let (mut base, mut res) = (self.0, 1 % P);
+        while exp != 0 {
+            if exp & 1 == 1 {
+                res = Self::mul_mod(res, base);
+            }
+            base = Self::mul_mod(base, base);
+            exp >>= 1;
+        }
+        Self(res)
+    }
+
+    /// Multiplicative inverse, by Fermat's little theorem (P must be prime)
+    #[inline]
+    pub fn inv(self) -> Self {
+        assert!(self.0 != 0, "ModP: division by zero");
+        self.pow(P - 2)
+    }
+}
+
+impl<const P: u64> Add for ModP<P> {
+    type Output = Self;
+
+    #[inline]
+    fn add(self, other: Self) -> Self {
+        let s = self.0 + other.0;
+        Self(if s >= P { s - P } else { s })
+    }
+}
+
+impl<const P: u64> Sub for ModP<P> {
+    type Output = Self;
+
+    #[inline]
+    fn sub(self, other: Self) -> Self {
+        Self(if self.0 >= other.0 {
+            self.0 - other.0
+        } else {
+            self.0 + P - other.0
+        })
+    }
+}
+
+impl<const P: u64> Mul for ModP<P> {
+    type Output = Self;
+
+    #[inline]
+    fn mul(self, other: Self) -> Self {
+        Self(Self::mul_mod(self.0, other.0))
+    }
+}
+
+impl<const P: u64> Div for ModP<P> {
+    type Output = Self;
+
+    #[inline]
+    #[allow(clippy::suspicious_arithmetic_impl)]
+    fn div(self, other: Self) -> Self {
+        self * other.inv()
+    }
+}
+
+impl<const P: u64> Rem for ModP<P> {
+    type Output = Self;
+
+    /// Division in a field is exact, so the remainder is always zero
+    #[inline]
+    fn rem(self, other: Self) -> Self {
+        assert!(other.0 != 0, "ModP: division by zero");
+        Self(0)
+    }
+}
+
+impl<const P: u64> Neg for ModP<P> {
+    type Output = Self;
+
+    #[inline]
+    fn neg(self) -> Self {
+        Self(if self.0 == 0 { 0 } else { P - self.0 })
+    }
+}
+
+impl<const P: u64> Zero for ModP<P> {
+    #[inline]
+    fn zero() -> Self {
+        Self(0)
+    }
+
+    #[inline]
+    fn is_zero(&self) -> bool {
+        self.0 == 0
+    }
+}
+
+impl<const P: u64> One for ModP<P> {
+    #[inline]
+    fn one() -> Self {
+        Self(1 % P)
+    }
+}
+
+impl<const P: u64> Num for ModP<P> {
+    type FromStrRadixErr = core::num::ParseIntError;
+
+    fn from_str_radix(s: &str, radix: u32) -> Result<Self, Self::FromStrRadixErr> {
+        i128::from_str_radix(s, radix).map(Self::new)
+    }
+}
+
+impl<const P: u64> Scalar for ModP<P> {
+    const ZERO: Self = Self(0);
+    const ONE: Self = Self(1 % P);
+    const NEG_ONE: Self = Self(P - 1);
+}
+
+/// Residues modulo `MERSENNE61`, `PRIME61_B` and `PRIME61_C`
+#[derive(Copy, Clone, Debug, Default, PartialEq, Eq, Hash)]
+pub struct MultiModP(
+    pub ModP<MERSENNE61>,
+    pub ModP<PRIME61_B>,
+    pub ModP<PRIME61_C>,
+);
+
+impl MultiModP {
+    /**
+    Residues of an integer
+
+    Equality holds only when all three residues agree, i.e. when the
+    difference is divisible by a 183-bit modulus.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::modp::MultiModP;
+    assert_eq!(MultiModP::new(-1) + MultiModP::new(1), MultiModP::new(0));
+    assert_ne!(MultiModP::new(1 << 61), MultiModP::new(1));
+    ```
+    */
+    #[inline]
+    pub fn new(value: i128) -> Self {
+        Self(ModP::new(value), ModP::new(value), ModP::new(value))
+    }
+
+    #[inline]
+    pub fn inv(self) -> Self {
+        Self(self.0.inv(), self.1.inv(), self.2.inv())
+    }
+}
+
+macro_rules! multi_op {
+    (impl $imp:ident, $method:ident) => {
+        impl $imp for MultiModP {
+            type Output = MultiModP;
+
+            #[inline]
+            fn $method(self, other: MultiModP) -> MultiModP {
+                MultiModP(
+                    self.0.$method(other.0),
+                    self.1.$method(other.1),
+                    self.2.$method(other.2),
+                )
+            }
+        }
+    };
+}
+
+multi_op!(impl Add, add);
+multi_op!(impl Sub, sub);
+multi_op!(impl Mul, mul);
+multi_op!(impl Div, div);
+multi_op!(impl Rem, rem);
+
+impl Neg for MultiModP {
+    type Output = MultiModP;
+
+    #[inline]
+    fn neg(self) -> MultiModP {
+        MultiModP(-self.0, -self.1, -self.2)
+    }
+}
+
+impl Zero for MultiModP {
+    #[inline]
+    fn zero() -> Self {
+        Self::ZERO
+    }
+
+    #[inline]
+    fn is_zero(&self) -> bool {
+        *self == Self::ZERO
+    }
+}
+
+impl One for MultiModP {
+    #[inline]
+    fn one() -> Self {
+        Self::ONE
+    }
+}
+
+impl Num for MultiModP {
+    type FromStrRadixErr = core::num::ParseIntError;
+
+    fn from_str_radix(s: &str, radix: u32) -> Result<Self, Self::FromStrRadixErr> {
+        i128::from_str_radix(s, radix).map(Self::new)
+    }
+}
+
+impl Scalar for MultiModP {
+    const ZERO: Self = Self(ModP::ZERO, ModP::ZERO, ModP::ZERO);
+    const ONE: Self = Self(ModP::ONE, ModP::ONE, ModP::ONE);
+    const NEG_ONE: Self = Self(ModP::NEG_ONE, ModP::NEG_ONE, ModP::NEG_ONE);
+}
+
+macro_rules! from_int {
+    ($($int:ident),*) => (
+        $(
+            impl<const P: u64> From<$int> for ModP<P> {
+                #[inline]
+                fn from(value: $int) -> Self {
+                    Self::new(value as i128)
+                }
+            }
+
+            impl From<$int> for MultiModP {
+                #[inline]
+                fn from(value: $int) -> Self {
+                    Self::new(value as i128)
+                }
+            }
+        )*
+    )
+}
+
+from_int!(i32, i64, i128);
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_object::{PgPoint, PgPointT};
+    use crate::pg_plane::{check_desargue, check_pappus, coincident, ProjPlane};
+
+    fn reduced<T: Scalar + From<i128>>(p: &PgPoint) -> PgPointT<T> {
+        PgPointT::new(p.coord.map(T::from))
+    }
+
+    #[test]
+    fn test_modp_field() {
+        let a = Mod61::new(-5);
+        let b = Mod61::new(1 << 100);
+        assert_eq!((a * b) / b, a);
+        assert_eq!(a.inv() * a, Mod61::ONE);
+        assert_eq!(a + -a, Mod61::ZERO);
+        assert_eq!(
+            Mod61::new(MERSENNE61 as i128 - 1) * Mod61::new(2),
+            Mod61::new(-2)
+        );
+        // generic reduction path agrees with the folding one
+        let (x, y) = (0x1234_5678_9abc_def0_i128, -0x0fed_cba9_8765_4321_i128);
+        assert_eq!(
+            (ModP::<PRIME61_B>::new(x) * ModP::new(y)).value(),
+            (x * y).rem_euclid(PRIME61_B as i128) as u64
+        );
+        assert_eq!(
+            (ModP::<1_000_000_007>::new(x) * ModP::new(y)).value(),
+            (x * y).rem_euclid(1_000_000_007) as u64
+        );
+    }
+
+    #[test]
+    fn test_modp_theorems() {
+        // coordinates far too large for the i128 predicates
+        let big = 1_i128 << 60;
+        let a = PgPoint::new([big - 3, 2 * big / 3, 7]);
+        let b = PgPoint::new([-big / 5, 11, big - 1]);
+        let d = PgPoint::new([13, big / 7, -big / 9]);
+        let e = PgPoint::new([big / 3, -big + 17, 5]);
+        let (a, b, d, e) = (reduced(&a), reduced(&b), reduced(&d), reduced(&e));
+        let c = a.plucker(&MultiModP::new(3), &b, &MultiModP::new(-7));
+        let f = d.plucker(&MultiModP::new(big), &e, &MultiModP::new(5));
+        assert!(check_pappus(&[a, b, c], &[d, e, f]));
+        let g = PgPointT::new([c.coord[0] + MultiModP::ONE, c.coord[1], c.coord[2]]);
+        assert!(!coincident(&a, &b, &g));
+        assert!(!check_pappus(&[a, b, g], &[d, e, f]));
+
+        // agrees with exact i128 evaluation on small inputs
+        let tri1 = [
+            PgPoint::new([1, 3, 2]),
+            PgPoint::new([-2, 1, -1]),
+            PgPoint::new([4, -3, 5]),
+        ];
+        let o = PgPoint::new([3, 1, 2]);
+        let persp = tri1.map(|p| p.plucker(&2, &o, &-3));
+        let other = [persp[0], persp[1], PgPoint::new([5, 2, -7])];
+        for tri2 in [persp, other] {
+            let exact = check_desargue(&tri1, &tri2);
+            let modular = check_desargue(
+                &tri1.map(|p| reduced::<Mod61>(&p)),
+                &tri2.map(|p| reduced(&p)),
+            );
+            assert_eq!(exact, modular);
+        }
+    }
+}
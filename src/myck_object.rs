@@ -1,20 +1,40 @@
-use crate::ck_plane::{CKPlane, CKPlanePrim};
-use crate::pg_object::{MyCKLine, MyCKPoint};
+use crate::ck_plane::{impl_fused_ck, CKPlane, CKPlanePrim};
+use crate::pg_object::{MyCKLineT, MyCKPointT, Scalar};
 
-impl CKPlanePrim<MyCKLine> for MyCKPoint {
+impl<T: Scalar> CKPlanePrim<MyCKLineT<T>> for MyCKPointT<T> {
     #[inline]
-    fn perp(&self) -> MyCKLine {
-        MyCKLine::new([-2 * self.coord[0], self.coord[1], -2 * self.coord[2]])
+    fn perp(&self) -> MyCKLineT<T> {
+        let two = T::ONE + T::ONE;
+        MyCKLineT::new([-two * self.coord[0], self.coord[1], -two * self.coord[2]])
     }
+
+    impl_fused_ck!(MyCKLineT<T>);
 }
 
-impl CKPlanePrim<MyCKPoint> for MyCKLine {
+impl<T: Scalar> CKPlanePrim<MyCKPointT<T>> for MyCKLineT<T> {
     #[inline]
-    fn perp(&self) -> MyCKPoint {
-        MyCKPoint::new([-self.coord[0], 2 * self.coord[1], -self.coord[2]])
+    fn perp(&self) -> MyCKPointT<T> {
+        let two = T::ONE + T::ONE;
+        MyCKPointT::new([-self.coord[0], two * self.coord[1], -self.coord[2]])
     }
+
+    impl_fused_ck!(MyCKPointT<T>);
 }
 
-impl CKPlane<MyCKLine, i128> for MyCKPoint {}
+impl<T: Scalar> CKPlane<MyCKLineT<T>, T> for MyCKPointT<T> {}
+
+impl<T: Scalar> CKPlane<MyCKPointT<T>, T> for MyCKLineT<T> {}
+
+impl MyCKPointT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> MyCKLineT<i128> {
+        MyCKLineT::new([-2 * self.coord[0], self.coord[1], -2 * self.coord[2]])
+    }
+}
 
-impl CKPlane<MyCKPoint, i128> for MyCKLine {}
+impl MyCKLineT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> MyCKPointT<i128> {
+        MyCKPointT::new([-self.coord[0], 2 * self.coord[1], -self.coord[2]])
+    }
+}
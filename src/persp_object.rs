@@ -1,46 +1,300 @@
 // Perspective Geometry
+//
+// The absolute is the pair of points `I_RE +- i I_IM` on the line `L_INF`.
+// The pole of a line `l` is `(I_RE . l) I_RE + (I_IM . l) I_IM`, a fixed
+// linear map of `l`; with the standard basis that map is
+// `[l0, l1 + l2, l1 + l2]`, so `perp`, `midpoint` and `is_parallel` below
+// are written out with the constant dots folded in. `PerspBasis` does the
+// same for an absolute given at run time: the map is derived once, and
+// `PerspBasis::shared` keeps the derived bases in a process-wide cache that
+// parallel workers read without contention.
 
-use crate::ck_plane::{CKPlane, CKPlanePrim};
-use crate::pg_object::{PerspLine, PerspPoint};
-use crate::pg_plane::{ProjPlane, ProjPlanePrim};
-// use crate::pg_object::{plckr, dot};
+use crate::ck_plane::{impl_fused_ck, CKPlane, CKPlanePrim};
+use crate::homography::Homography;
+use crate::pg_object::{cross, dot, plckr, PerspLineT, PerspPointT, Scalar};
+use crate::pg_plane::ProjPlane;
+use std::collections::HashMap;
+use std::sync::{Arc, OnceLock, RwLock};
 
-static I_RE: PerspPoint = PerspPoint { coord: [0, 1, 1] };
-static I_IM: PerspPoint = PerspPoint { coord: [1, 0, 0] };
-static L_INF: PerspLine = PerspLine { coord: [0, -1, 1] };
+impl<T: Scalar> PerspPointT<T> {
+    pub const I_RE: Self = Self {
+        coord: [T::ZERO, T::ONE, T::ONE],
+    };
+    pub const I_IM: Self = Self {
+        coord: [T::ONE, T::ZERO, T::ZERO],
+    };
+}
+
+impl<T: Scalar> PerspLineT<T> {
+    pub const L_INF: Self = Self {
+        coord: [T::ZERO, T::NEG_ONE, T::ONE],
+    };
+}
+
+impl<T: Scalar> CKPlanePrim<PerspLineT<T>> for PerspPointT<T> {
+    #[inline]
+    fn perp(&self) -> PerspLineT<T> {
+        PerspLineT::L_INF
+    }
+
+    impl_fused_ck!(PerspLineT<T>);
+}
+
+impl<T: Scalar> CKPlanePrim<PerspPointT<T>> for PerspLineT<T> {
+    #[inline]
+    fn perp(&self) -> PerspPointT<T> {
+        // (I_RE . l) I_RE + (I_IM . l) I_IM
+        let [l0, l1, l2] = self.coord;
+        let alpha = l1 + l2;
+        PerspPointT::new([l0, alpha, alpha])
+    }
+
+    impl_fused_ck!(PerspPointT<T>);
+}
+
+impl<T: Scalar> CKPlane<PerspLineT<T>, T> for PerspPointT<T> {}
 
-impl CKPlanePrim<PerspLine> for PerspPoint {
+impl<T: Scalar> CKPlane<PerspPointT<T>, T> for PerspLineT<T> {}
+
+impl<T: Scalar> PerspLineT<T> {
     #[inline]
-    fn perp(&self) -> PerspLine {
-        L_INF.clone()
+    pub fn is_parallel(&self, other: &PerspLineT<T>) -> bool {
+        // L_INF . (self x other)
+        let (a, b) = (&self.coord, &other.coord);
+        a[0] * (b[1] + b[2]) == b[0] * (a[1] + a[2])
     }
 }
 
-impl CKPlanePrim<PerspPoint> for PerspLine {
+impl<T: Scalar> PerspPointT<T> {
     #[inline]
-    fn perp(&self) -> PerspPoint {
-        let alpha = I_RE.dot(self); // ???
-        let beta = I_IM.dot(self); // ???
-        PerspPoint::plucker(&I_RE, &alpha, &I_IM, &beta)
+    pub fn midpoint(&self, other: &PerspPointT<T>) -> PerspPointT<T> {
+        // L_INF . p = p2 - p1
+        let alpha = other.coord[2] - other.coord[1];
+        let beta = self.coord[2] - self.coord[1];
+        self.plucker(&alpha, other, &beta)
     }
 }
 
-impl CKPlane<PerspLine, i128> for PerspPoint {}
+impl PerspPointT<i128> {
+    #[inline]
+    pub const fn perp_const(&self) -> PerspLineT<i128> {
+        PerspLineT::<i128>::L_INF
+    }
+}
 
-impl CKPlane<PerspPoint, i128> for PerspLine {}
+impl PerspLineT<i128> {
+    /**
+    `perp` on i128 coordinates, usable in constants
 
-impl PerspLine {
+    Examples:
+
+    ```rust
+    use projgeom_rs::{CKPlanePrim, PerspLine, PerspPoint};
+    const M: PerspLine = PerspLine::new([3, -1, 7]);
+    const P: PerspPoint = M.perp_const();
+    assert_eq!(P, M.perp());
+    ```
+    */
     #[inline]
-    pub fn is_parallel(&self, other: &PerspLine) -> bool {
-        L_INF.dot(&self.circ(other)) == 0
+    pub const fn perp_const(&self) -> PerspPointT<i128> {
+        let alpha = self.coord[1] + self.coord[2];
+        PerspPointT::new([self.coord[0], alpha, alpha])
     }
 }
 
-impl PerspPoint {
+/**
+Perspective absolute given at run time
+
+Examples:
+
+```rust
+use projgeom_rs::persp_object::PerspBasis;
+use projgeom_rs::{CKPlanePrim, PerspLine, PerspPoint};
+let basis = PerspBasis::standard();
+let l = PerspLine::new([3, -1, 7]);
+assert_eq!(basis.perp::<_, PerspPoint>(&l), l.perp());
+```
+*/
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct PerspBasis<T> {
+    pub i_re: [T; 3],
+    pub i_im: [T; 3],
+    pub l_inf: [T; 3],
+    /// Line to pole: `i_re i_re^T + i_im i_im^T`
+    pole: Homography<T>,
+}
+
+impl<T: Scalar> PerspBasis<T> {
+    pub fn new(i_re: [T; 3], i_im: [T; 3], l_inf: [T; 3]) -> Self {
+        let mut mat = [[T::ZERO; 3]; 3];
+        for i in 0..3 {
+            for j in 0..3 {
+                mat[i][j] = i_re[i] * i_re[j] + i_im[i] * i_im[j];
+            }
+        }
+        Self {
+            i_re,
+            i_im,
+            l_inf,
+            pole: Homography::new(mat),
+        }
+    }
+
+    /// The absolute of `PerspPointT`
+    #[inline]
+    pub fn standard() -> Self {
+        Self::new(
+            PerspPointT::<T>::I_RE.coord,
+            PerspPointT::<T>::I_IM.coord,
+            PerspLineT::<T>::L_INF.coord,
+        )
+    }
+
+    /// The derived line-to-pole matrix
     #[inline]
-    pub fn midpoint(&self, other: &PerspPoint) -> PerspPoint {
-        let alpha = L_INF.dot(other);
-        let beta = L_INF.dot(self);
-        PerspPoint::plucker(self, &alpha, other, &beta)
+    pub fn pole_matrix(&self) -> &Homography<T> {
+        &self.pole
+    }
+
+    /// Pole of a line
+    #[inline]
+    pub fn perp<L, P>(&self, line: &L) -> P
+    where
+        L: AsRef<[T; 3]>,
+        P: From<[T; 3]>,
+    {
+        P::from(self.pole.apply_coord(line.as_ref()))
+    }
+
+    #[inline]
+    pub fn midpoint<P>(&self, a: &P, b: &P) -> P
+    where
+        P: AsRef<[T; 3]> + From<[T; 3]>,
+    {
+        let (a, b) = (a.as_ref(), b.as_ref());
+        P::from(plckr(&dot(&self.l_inf, b), a, &dot(&self.l_inf, a), b))
+    }
+
+    #[inline]
+    pub fn is_parallel<L: AsRef<[T; 3]>>(&self, l: &L, m: &L) -> bool {
+        // parallel lines meet on `l_inf`
+        dot(&self.l_inf, &cross(l.as_ref(), m.as_ref())) == T::ZERO
+    }
+}
+
+type BasisKey = [[i128; 3]; 3];
+
+static SHARED: OnceLock<RwLock<HashMap<BasisKey, Arc<PerspBasis<i128>>>>> = OnceLock::new();
+
+impl PerspBasis<i128> {
+    /**
+    The basis for an absolute, derived on first use and shared afterwards
+
+    Lookups take a read lock only; a basis is derived under the write lock
+    at most once per absolute.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::persp_object::PerspBasis;
+    use std::sync::Arc;
+    let a = PerspBasis::shared([0, 1, 1], [1, 0, 0], [0, -1, 1]);
+    let b = PerspBasis::shared([0, 1, 1], [1, 0, 0], [0, -1, 1]);
+    assert!(Arc::ptr_eq(&a, &b));
+    ```
+    */
+    pub fn shared(i_re: [i128; 3], i_im: [i128; 3], l_inf: [i128; 3]) -> Arc<Self> {
+        let key = [i_re, i_im, l_inf];
+        let cache = SHARED.get_or_init(|| RwLock::new(HashMap::new()));
+        if let Some(basis) = cache.read().unwrap().get(&key) {
+            return basis.clone();
+        }
+        cache
+            .write()
+            .unwrap()
+            .entry(key)
+            .or_insert_with(|| Arc::new(Self::new(i_re, i_im, l_inf)))
+            .clone()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_object::{PerspLine, PerspPoint, PgLine, PgPoint};
+    use crate::pg_plane::ProjPlanePrim;
+
+    #[test]
+    fn test_folded_matches_definition() {
+        let (re, im) = (PerspPointT::<i64>::I_RE, PerspPointT::<i64>::I_IM);
+        let inf = PerspLineT::<i64>::L_INF;
+        let coords = [[13, 23, 32], [44, -34, 2], [-2, 12, 23], [3, -1, 7]];
+        for a in coords {
+            let l = PerspLineT::<i64>::new(a);
+            let expected = re.plucker(&re.dot(&l), &im, &im.dot(&l));
+            assert_eq!(l.perp().coord, expected.coord);
+            let wide = PerspLine::new(a.map(i128::from));
+            assert_eq!(wide.perp_const(), wide.perp());
+            for b in coords {
+                let (p, q) = (PerspPointT::<i64>::new(a), PerspPointT::<i64>::new(b));
+                let expected = p.plucker(&inf.dot(&q), &q, &inf.dot(&p));
+                assert_eq!(p.midpoint(&q).coord, expected.coord);
+                let m = PerspLineT::<i64>::new(b);
+                assert_eq!(l.is_parallel(&m), inf.dot(&l.circ(&m)) == 0);
+            }
+        }
+        assert!(PerspLineT::<i64>::new([1, 2, 3]).is_parallel(&PerspLineT::new([2, 7, 3])));
+    }
+
+    #[test]
+    fn test_basis() {
+        let basis = PerspBasis::<i128>::standard();
+        let shared = PerspBasis::shared([0, 1, 1], [1, 0, 0], [0, -1, 1]);
+        assert_eq!(*shared, basis);
+        let (p, q) = (PerspPoint::new([13, 23, 32]), PerspPoint::new([44, -34, 2]));
+        assert_eq!(basis.midpoint(&p, &q), p.midpoint(&q));
+        let (l, m) = (p.circ(&q), PerspLine::new([3, -1, 7]));
+        assert_eq!(basis.perp::<_, PerspPoint>(&l), l.perp());
+        assert_eq!(basis.is_parallel(&l, &m), l.is_parallel(&m));
+
+        // a different absolute, on plain projective objects
+        let skew = PerspBasis::shared([1, 1, 0], [0, 1, 2], [2, -2, 1]);
+        let l = PgLine::new([3, -1, 7]);
+        let pole: PgPoint = skew.perp(&l);
+        let expected = PgPoint::new(skew.i_re).plucker(
+            &dot(&skew.i_re, &l.coord),
+            &PgPoint::new(skew.i_im),
+            &dot(&skew.i_im, &l.coord),
+        );
+        assert_eq!(pole, expected);
+
+        // concurrent lookups all see the same basis
+        let ptrs: Vec<usize> = std::thread::scope(|s| {
+            let hs: Vec<_> = (0..4)
+                .map(|_| {
+                    s.spawn(|| {
+                        Arc::as_ptr(&PerspBasis::shared([1, 1, 0], [0, 1, 2], [2, -2, 1])) as usize
+                    })
+                })
+                .collect();
+            hs.into_iter().map(|h| h.join().unwrap()).collect()
+        });
+        assert!(ptrs.iter().all(|p| *p == Arc::as_ptr(&skew) as usize));
+    }
+
+    #[cfg(feature = "metrics")]
+    #[test]
+    fn test_midpoint_metrics() {
+        use crate::metrics::{self, Op};
+        let _guard = metrics::test_guard();
+        let before = metrics::local_snapshot();
+        let (p, q) = (
+            PerspPoint::new([1 << 40, 23, 32]),
+            PerspPoint::new([44, -34, 2]),
+        );
+        let _ = p.midpoint(&q);
+        let d = metrics::local_snapshot();
+        assert_eq!(d.count(Op::Plucker) - before.count(Op::Plucker), 1);
+        assert!(d.above(40) > before.above(40));
     }
 }
@@ -0,0 +1,387 @@
+// Structure-of-arrays batches of points and lines
+//
+// The x/y/z components are kept in separate contiguous columns so that
+// the element-wise kernels below are plain loops over slices, which the
+// compiler is free to unroll and vectorize.
+
+use crate::homography::Homography;
+use crate::pg_object::*;
+
+/**
+Element-wise cross product of two column batches
+
+Examples:
+
+```rust
+use projgeom_rs::pg_batch::cross_many;
+let (mut x, mut y, mut z) = (vec![0; 1], vec![0; 1], vec![0; 1]);
+cross_many([&[1], &[2], &[3]], [&[3], &[4], &[5]], [&mut x, &mut y, &mut z]);
+assert_eq!((x[0], y[0], z[0]), (-2, 4, -2));
+```
+*/
+#[inline]
+pub fn cross_many<T: Scalar>(a: [&[T]; 3], b: [&[T]; 3], out: [&mut [T]; 3]) {
+    let n = out[0].len();
+    let [ax, ay, az] = a;
+    let [bx, by, bz] = b;
+    let (ax, ay, az) = (&ax[..n], &ay[..n], &az[..n]);
+    let (bx, by, bz) = (&bx[..n], &by[..n], &bz[..n]);
+    let [ox, oy, oz] = out;
+    let (oy, oz) = (&mut oy[..n], &mut oz[..n]);
+    for i in 0..n {
+        ox[i] = ay[i] * bz[i] - az[i] * by[i];
+        oy[i] = az[i] * bx[i] - ax[i] * bz[i];
+        oz[i] = ax[i] * by[i] - ay[i] * bx[i];
+    }
+}
+
+/**
+Element-wise dot product of two column batches
+
+Examples:
+
+```rust
+use projgeom_rs::pg_batch::dot_many;
+let mut out = vec![0; 2];
+dot_many([&[1, 0], &[2, 1], &[3, 0]], [&[3, 7], &[4, 0], &[5, 1]], &mut out);
+assert_eq!(out, [26, 0]);
+```
+*/
+#[inline]
+pub fn dot_many<T: Scalar>(a: [&[T]; 3], b: [&[T]; 3], out: &mut [T]) {
+    let n = out.len();
+    let [ax, ay, az] = a;
+    let [bx, by, bz] = b;
+    let (ax, ay, az) = (&ax[..n], &ay[..n], &az[..n]);
+    let (bx, by, bz) = (&bx[..n], &by[..n], &bz[..n]);
+    for i in 0..n {
+        out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+    }
+}
+
+/**
+Element-wise incidence of two column batches, by `Scalar::dot_is_zero`
+as in every `incident`
+
+Examples:
+
+```rust
+use projgeom_rs::pg_batch::incident_many;
+let mut out = vec![false; 2];
+let (a, b) = ([&[1e16, 1.0][..], &[1.0, 2.0], &[-1e16, 3.0]], [&[1.0, 1.0][..], &[1.0, 1.0], &[1.0, -1.0]]);
+incident_many(a, b, &mut out);
+assert_eq!(out, [false, true]); // 1e16 + 1 - 1e16 rounds to zero, but is 1
+```
+*/
+#[inline]
+pub fn incident_many<T: Scalar>(a: [&[T]; 3], b: [&[T]; 3], out: &mut [bool]) {
+    let n = out.len();
+    let [ax, ay, az] = a;
+    let [bx, by, bz] = b;
+    let (ax, ay, az) = (&ax[..n], &ay[..n], &az[..n]);
+    let (bx, by, bz) = (&bx[..n], &by[..n], &bz[..n]);
+    for i in 0..n {
+        out[i] = T::dot_is_zero(&[ax[i], ay[i], az[i]], &[bx[i], by[i], bz[i]]);
+    }
+}
+
+/**
+Element-wise Plucker operation of two column batches
+
+Examples:
+
+```rust
+use projgeom_rs::pg_batch::plckr_many;
+let (mut x, mut y, mut z) = (vec![0; 1], vec![0; 1], vec![0; 1]);
+plckr_many(&[1], [&[1], &[2], &[3]], &[-1], [&[3], &[4], &[5]], [&mut x, &mut y, &mut z]);
+assert_eq!((x[0], y[0], z[0]), (-2, -2, -2));
+```
+*/
+#[inline]
+pub fn plckr_many<T: Scalar>(ld: &[T], p: [&[T]; 3], mu: &[T], q: [&[T]; 3], out: [&mut [T]; 3]) {
+    let n = out[0].len();
+    let (ld, mu) = (&ld[..n], &mu[..n]);
+    let [px, py, pz] = p;
+    let [qx, qy, qz] = q;
+    let (px, py, pz) = (&px[..n], &py[..n], &pz[..n]);
+    let (qx, qy, qz) = (&qx[..n], &qy[..n], &qz[..n]);
+    let [ox, oy, oz] = out;
+    let (oy, oz) = (&mut oy[..n], &mut oz[..n]);
+    for i in 0..n {
+        ox[i] = ld[i] * px[i] + mu[i] * qx[i];
+        oy[i] = ld[i] * py[i] + mu[i] * qy[i];
+        oz[i] = ld[i] * pz[i] + mu[i] * qz[i];
+    }
+}
+
+macro_rules! define_batch {
+    (impl $batch:ident, $point:ident) => {
+        /// Structure-of-arrays batch of homogeneous coordinates
+        #[derive(Debug, Clone, Default, PartialEq, Eq)]
+        pub struct $batch<T> {
+            pub x: Vec<T>,
+            pub y: Vec<T>,
+            pub z: Vec<T>,
+        }
+
+        impl<T: Scalar> $batch<T> {
+            #[inline]
+            pub fn new() -> Self {
+                Self::default()
+            }
+
+            #[inline]
+            pub fn with_capacity(n: usize) -> Self {
+                Self {
+                    x: Vec::with_capacity(n),
+                    y: Vec::with_capacity(n),
+                    z: Vec::with_capacity(n),
+                }
+            }
+
+            #[inline]
+            fn zeros(n: usize) -> Self {
+                Self {
+                    x: vec![T::ZERO; n],
+                    y: vec![T::ZERO; n],
+                    z: vec![T::ZERO; n],
+                }
+            }
+
+            #[inline]
+            pub fn len(&self) -> usize {
+                self.x.len()
+            }
+
+            #[inline]
+            pub fn is_empty(&self) -> bool {
+                self.x.is_empty()
+            }
+
+            #[inline]
+            pub fn clear(&mut self) {
+                self.x.clear();
+                self.y.clear();
+                self.z.clear();
+            }
+
+            #[inline]
+            pub fn push(&mut self, p: &$point<T>) {
+                self.x.push(p.coord[0]);
+                self.y.push(p.coord[1]);
+                self.z.push(p.coord[2]);
+            }
+
+            #[inline]
+            pub fn get(&self, i: usize) -> $point<T> {
+                $point::new([self.x[i], self.y[i], self.z[i]])
+            }
+
+            pub fn from_slice(pts: &[$point<T>]) -> Self {
+                let mut res = Self::with_capacity(pts.len());
+                for p in pts {
+                    res.push(p);
+                }
+                res
+            }
+
+            pub fn to_vec(&self) -> Vec<$point<T>> {
+                (0..self.len()).map(|i| self.get(i)).collect()
+            }
+
+            /// Apply `h` to every element (pass `h.line_map()` for lines)
+            pub fn transform(&self, h: &Homography<T>) -> Self {
+                let mut res = Self::zeros(self.len());
+                h.apply_many(self.columns(), res.columns_mut());
+                res
+            }
+
+            #[inline]
+            fn columns(&self) -> [&[T]; 3] {
+                [&self.x, &self.y, &self.z]
+            }
+
+            #[inline]
+            fn columns_mut(&mut self) -> [&mut [T]; 3] {
+                [&mut self.x, &mut self.y, &mut self.z]
+            }
+        }
+    };
+}
+
+macro_rules! define_batch_for_batch {
+    (impl $lbatch:ident, $pbatch:ident, $line:ident) => {
+        impl<T: Scalar> $pbatch<T> {
+            /// Element-wise join (or meet): `self[i].circ(&rhs[i])`
+            pub fn circ_many(&self, rhs: &Self) -> $lbatch<T> {
+                assert_eq!(self.len(), rhs.len());
+                let mut res = $lbatch::zeros(self.len());
+                cross_many(self.columns(), rhs.columns(), res.columns_mut());
+                res
+            }
+
+            /// Element-wise basic measurement: `self[i].dot(&lines[i])`
+            pub fn dot_many(&self, lines: &$lbatch<T>) -> Vec<T> {
+                assert_eq!(self.len(), lines.len());
+                let mut res = vec![T::ZERO; self.len()];
+                dot_many(self.columns(), lines.columns(), &mut res);
+                res
+            }
+
+            /// Element-wise incidence: `self[i].incident(&lines[i])`
+            pub fn incident_mask(&self, lines: &$lbatch<T>) -> Vec<bool> {
+                assert_eq!(self.len(), lines.len());
+                let mut res = vec![false; self.len()];
+                incident_many(self.columns(), lines.columns(), &mut res);
+                res
+            }
+
+            /// Incidence of every element with a single line
+            pub fn incident_mask_with(&self, line: &$line<T>) -> Vec<bool> {
+                self.x
+                    .iter()
+                    .zip(&self.y)
+                    .zip(&self.z)
+                    .map(|((x, y), z)| T::dot_is_zero(&[*x, *y, *z], &line.coord))
+                    .collect()
+            }
+
+            /// Element-wise `plucker(&ld[i], &q[i], &mu[i])`
+            pub fn plucker_many(&self, ld: &[T], q: &Self, mu: &[T]) -> Self {
+                assert_eq!(self.len(), q.len());
+                assert_eq!(self.len(), ld.len());
+                assert_eq!(self.len(), mu.len());
+                let mut res = Self::zeros(self.len());
+                plckr_many(ld, self.columns(), mu, q.columns(), res.columns_mut());
+                res
+            }
+        }
+
+        #[cfg(feature = "parallel")]
+        impl<T: Scalar + Send + Sync> $pbatch<T> {
+            /// Parallel version of `circ_many`
+            pub fn par_circ_many(&self, rhs: &Self) -> $lbatch<T> {
+                assert_eq!(self.len(), rhs.len());
+                let mut res = $lbatch::zeros(self.len());
+                crate::pg_parallel::par_cross_many(
+                    self.columns(),
+                    rhs.columns(),
+                    res.columns_mut(),
+                );
+                res
+            }
+
+            /// Parallel version of `dot_many`
+            pub fn par_dot_many(&self, lines: &$lbatch<T>) -> Vec<T> {
+                assert_eq!(self.len(), lines.len());
+                let mut res = vec![T::ZERO; self.len()];
+                crate::pg_parallel::par_dot_many(self.columns(), lines.columns(), &mut res);
+                res
+            }
+
+            /// Parallel version of `incident_mask`
+            pub fn par_incident_mask(&self, lines: &$lbatch<T>) -> Vec<bool> {
+                assert_eq!(self.len(), lines.len());
+                let mut res = vec![false; self.len()];
+                crate::pg_parallel::par_incident_many(self.columns(), lines.columns(), &mut res);
+                res
+            }
+        }
+    };
+}
+
+macro_rules! define_point_and_line_batch {
+    (impl $pbatch:ident, $lbatch:ident, $point:ident, $line:ident) => {
+        define_batch!(impl $pbatch, $point);
+        define_batch!(impl $lbatch, $line);
+        define_batch_for_batch!(impl $lbatch, $pbatch, $line);
+        define_batch_for_batch!(impl $pbatch, $lbatch, $point);
+    };
+}
+
+define_point_and_line_batch!(impl PgPointBatchT, PgLineBatchT, PgPointT, PgLineT);
+define_point_and_line_batch!(impl HypPointBatchT, HypLineBatchT, HypPointT, HypLineT);
+define_point_and_line_batch!(impl EllPointBatchT, EllLineBatchT, EllPointT, EllLineT);
+define_point_and_line_batch!(impl MyCKPointBatchT, MyCKLineBatchT, MyCKPointT, MyCKLineT);
+define_point_and_line_batch!(
+    impl PerspPointBatchT,
+    PerspLineBatchT,
+    PerspPointT,
+    PerspLineT
+);
+define_point_and_line_batch!(
+    impl EuclidPointBatchT,
+    EuclidLineBatchT,
+    EuclidPointT,
+    EuclidLineT
+);
+
+pub type PgPointBatch = PgPointBatchT<i128>;
+pub type PgLineBatch = PgLineBatchT<i128>;
+pub type HypPointBatch = HypPointBatchT<i128>;
+pub type HypLineBatch = HypLineBatchT<i128>;
+pub type EllPointBatch = EllPointBatchT<i128>;
+pub type EllLineBatch = EllLineBatchT<i128>;
+pub type MyCKPointBatch = MyCKPointBatchT<i128>;
+pub type MyCKLineBatch = MyCKLineBatchT<i128>;
+pub type PerspPointBatch = PerspPointBatchT<i128>;
+pub type PerspLineBatch = PerspLineBatchT<i128>;
+pub type EuclidPointBatch = EuclidPointBatchT<i128>;
+pub type EuclidLineBatch = EuclidLineBatchT<i128>;
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+
+    #[test]
+    fn test_pg_batch() {
+        let pts = [
+            PgPoint::new([1, 3, 2]),
+            PgPoint::new([-2, 1, -1]),
+            PgPoint::new([13, 23, 32]),
+        ];
+        let qts = [
+            PgPoint::new([-2, 1, -1]),
+            PgPoint::new([44, -34, 2]),
+            PgPoint::new([-2, 12, 23]),
+        ];
+        let p = PgPointBatch::from_slice(&pts);
+        let q = PgPointBatch::from_slice(&qts);
+        assert_eq!(p.to_vec(), pts);
+
+        let l = p.circ_many(&q);
+        for i in 0..p.len() {
+            assert_eq!(l.get(i), pts[i].circ(&qts[i]));
+        }
+        assert_eq!(p.incident_mask(&l), [true, true, true]);
+        assert_eq!(q.incident_mask(&l), [true, true, true]);
+        assert_eq!(p.incident_mask_with(&l.get(0)), [true, true, false]);
+
+        let ld = [2, 3, 5];
+        let mu = [7, -1, 4];
+        let r = p.plucker_many(&ld, &q, &mu);
+        for i in 0..p.len() {
+            assert_eq!(r.get(i), pts[i].plucker(&ld[i], &qts[i], &mu[i]));
+        }
+        assert_eq!(r.dot_many(&l), [0, 0, 0]);
+    }
+
+    #[test]
+    fn test_f64_incidence_matches_scalar() {
+        // naive dot products round to zero on the first two rows
+        let pts = [[1e16, 1.0, -1e16], [3.0, 1e-17, 1.0], [1.0, 2.0, 3.0]].map(PgPointT::new);
+        let lines = [[1.0, 1.0, 1.0], [1.0, 1.0, -3.0], [1.0, 1.0, -1.0]].map(PgLineT::new);
+        let (p, l) = (
+            PgPointBatchT::from_slice(&pts),
+            PgLineBatchT::from_slice(&lines),
+        );
+        let expected: Vec<bool> = pts.iter().zip(&lines).map(|(p, l)| p.incident(l)).collect();
+        assert_eq!(expected, [false, false, true]);
+        assert_eq!(p.incident_mask(&l), expected);
+        #[cfg(feature = "parallel")]
+        assert_eq!(p.par_incident_mask(&l), expected);
+        let with: Vec<bool> = pts.iter().map(|p| p.incident(&lines[0])).collect();
+        assert_eq!(p.incident_mask_with(&lines[0]), with);
+    }
+}
@@ -0,0 +1,450 @@
+// Binary point/line arrays and a chunked streaming evaluator
+//
+// A file is a 32-byte header followed by `count` coordinate triples stored
+// x, y, z in little-endian order, each coordinate `width` bytes wide:
+//
+//     0..4    magic b"PGEO"
+//     4       format version (1)
+//     5       element kind (0 = points, 1 = lines)
+//     6       geometry (see `Geometry`)
+//     7       coordinate width in bytes (4, 8 or 16)
+//     8..16   element count, u64
+//     16..32  reserved, zero
+//
+// The payload starts 32 bytes in, so a page-aligned buffer (as returned by
+// memory mapping the file) keeps every coordinate naturally aligned.
+// `CoordView` reads elements straight out of such a byte slice without
+// copying it; `map_stream` runs an operation over a `Read` source in fixed
+// size chunks so memory stays bounded however long the input is.
+
+use crate::pg_object::Scalar;
+use std::io::{self, Read, Write};
+
+pub const MAGIC: [u8; 4] = *b"PGEO";
+pub const VERSION: u8 = 1;
+pub const HEADER_LEN: usize = 32;
+
+/// Coordinate types with a fixed-width little-endian encoding
+pub trait BinCoord: Scalar {
+    const WIDTH: u8;
+
+    /// Decode from the first `WIDTH` bytes of `bytes`
+    fn read_le(bytes: &[u8]) -> Self;
+
+    /// Append the `WIDTH`-byte encoding to `out`
+    fn write_le(&self, out: &mut Vec<u8>);
+}
+
+macro_rules! impl_bin_coord {
+    ($($int:ident),*) => (
+        $(
+            impl BinCoord for $int {
+                const WIDTH: u8 = core::mem::size_of::<$int>() as u8;
+
+                #[inline]
+                fn read_le(bytes: &[u8]) -> Self {
+                    let mut buf = [0; core::mem::size_of::<$int>()];
+                    buf.copy_from_slice(&bytes[..Self::WIDTH as usize]);
+                    $int::from_le_bytes(buf)
+                }
+
+                #[inline]
+                fn write_le(&self, out: &mut Vec<u8>) {
+                    out.extend_from_slice(&self.to_le_bytes());
+                }
+            }
+        )*
+    )
+}
+
+impl_bin_coord!(i32, i64, i128);
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum Kind {
+    Point = 0,
+    Line = 1,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub enum Geometry {
+    Pg = 0,
+    Ell = 1,
+    Hyp = 2,
+    Euclid = 3,
+    Persp = 4,
+    MyCK = 5,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct Header {
+    pub kind: Kind,
+    pub geometry: Geometry,
+    /// Coordinate width in bytes
+    pub width: u8,
+    pub count: u64,
+}
+
+fn invalid(msg: &str) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, msg)
+}
+
+impl Header {
+    #[inline]
+    pub fn new<T: BinCoord>(kind: Kind, geometry: Geometry, count: u64) -> Self {
+        Self {
+            kind,
+            geometry,
+            width: T::WIDTH,
+            count,
+        }
+    }
+
+    /// Size of one element (three coordinates) in bytes
+    #[inline]
+    pub fn stride(&self) -> usize {
+        3 * self.width as usize
+    }
+
+    pub fn to_bytes(&self) -> [u8; HEADER_LEN] {
+        let mut res = [0; HEADER_LEN];
+        res[..4].copy_from_slice(&MAGIC);
+        res[4] = VERSION;
+        res[5] = self.kind as u8;
+        res[6] = self.geometry as u8;
+        res[7] = self.width;
+        res[8..16].copy_from_slice(&self.count.to_le_bytes());
+        res
+    }
+
+    /**
+    Parse and validate a header
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::pg_io::{Geometry, Header, Kind};
+    let h = Header::new::<i64>(Kind::Line, Geometry::Hyp, 7);
+    assert_eq!(Header::from_bytes(&h.to_bytes()).unwrap(), h);
+    assert!(Header::from_bytes(b"not a header").is_err());
+    ```
+    */
+    pub fn from_bytes(bytes: &[u8]) -> io::Result<Self> {
+        if bytes.len() < HEADER_LEN || bytes[..4] != MAGIC {
+            return Err(invalid("pg_io: not a PGEO file"));
+        }
+        if bytes[4] != VERSION {
+            return Err(invalid("pg_io: unsupported version"));
+        }
+        let kind = match bytes[5] {
+            0 => Kind::Point,
+            1 => Kind::Line,
+            _ => return Err(invalid("pg_io: unknown element kind")),
+        };
+        let geometry = match bytes[6] {
+            0 => Geometry::Pg,
+            1 => Geometry::Ell,
+            2 => Geometry::Hyp,
+            3 => Geometry::Euclid,
+            4 => Geometry::Persp,
+            5 => Geometry::MyCK,
+            _ => return Err(invalid("pg_io: unknown geometry")),
+        };
+        let width = bytes[7];
+        if !matches!(width, 4 | 8 | 16) {
+            return Err(invalid("pg_io: unsupported coordinate width"));
+        }
+        let mut count = [0; 8];
+        count.copy_from_slice(&bytes[8..16]);
+        Ok(Self {
+            kind,
+            geometry,
+            width,
+            count: u64::from_le_bytes(count),
+        })
+    }
+
+    fn check_width<T: BinCoord>(&self) -> io::Result<()> {
+        if self.width != T::WIDTH {
+            return Err(invalid("pg_io: coordinate width does not match"));
+        }
+        Ok(())
+    }
+}
+
+#[inline]
+fn encode<T: BinCoord>(coord: &[T; 3], out: &mut Vec<u8>) {
+    coord.iter().for_each(|c| c.write_le(out));
+}
+
+#[inline]
+fn decode<T: BinCoord>(bytes: &[u8]) -> [T; 3] {
+    let w = T::WIDTH as usize;
+    [
+        T::read_le(bytes),
+        T::read_le(&bytes[w..]),
+        T::read_le(&bytes[2 * w..]),
+    ]
+}
+
+/**
+Write a header and the coordinates of `objs`
+
+Examples:
+
+```rust
+use projgeom_rs::pg_io::{write_objects, CoordView, Geometry, Kind};
+use projgeom_rs::PgPoint;
+let pts = [PgPoint::new([1, 3, 2]), PgPoint::new([-2, 1, -1])];
+let mut buf = Vec::new();
+write_objects(&mut buf, Kind::Point, Geometry::Pg, &pts).unwrap();
+let view = CoordView::<i128>::new(&buf).unwrap();
+assert_eq!(view.get(1), [-2, 1, -1]);
+```
+*/
+pub fn write_objects<W, T, O>(
+    w: &mut W,
+    kind: Kind,
+    geometry: Geometry,
+    objs: &[O],
+) -> io::Result<()>
+where
+    W: Write,
+    T: BinCoord,
+    O: AsRef<[T; 3]>,
+{
+    let header = Header::new::<T>(kind, geometry, objs.len() as u64);
+    w.write_all(&header.to_bytes())?;
+    let mut buf = Vec::with_capacity(header.stride() * objs.len().min(4096));
+    for chunk in objs.chunks(4096) {
+        buf.clear();
+        chunk.iter().for_each(|o| encode(o.as_ref(), &mut buf));
+        w.write_all(&buf)?;
+    }
+    Ok(())
+}
+
+/// Borrowed, zero-copy view of an encoded array (e.g. a memory-mapped file)
+#[derive(Debug, Clone, Copy)]
+pub struct CoordView<'a, T> {
+    header: Header,
+    data: &'a [u8],
+    marker: core::marker::PhantomData<T>,
+}
+
+impl<'a, T: BinCoord> CoordView<'a, T> {
+    /// Validate the header and the payload length of `bytes`
+    pub fn new(bytes: &'a [u8]) -> io::Result<Self> {
+        let header = Header::from_bytes(bytes)?;
+        header.check_width::<T>()?;
+        let len = (header.count as usize)
+            .checked_mul(header.stride())
+            .ok_or_else(|| invalid("pg_io: element count too large"))?;
+        let data = bytes[HEADER_LEN..]
+            .get(..len)
+            .ok_or_else(|| invalid("pg_io: truncated payload"))?;
+        Ok(Self {
+            header,
+            data,
+            marker: core::marker::PhantomData,
+        })
+    }
+
+    #[inline]
+    pub fn header(&self) -> &Header {
+        &self.header
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.header.count as usize
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.header.count == 0
+    }
+
+    #[inline]
+    pub fn get(&self, i: usize) -> [T; 3] {
+        let stride = self.header.stride();
+        decode(&self.data[i * stride..(i + 1) * stride])
+    }
+
+    #[inline]
+    pub fn iter(&self) -> impl Iterator<Item = [T; 3]> + 'a {
+        self.data
+            .chunks_exact(self.header.stride())
+            .map(|bytes| decode(bytes))
+    }
+}
+
+/// Reads an encoded array from a `Read` source a chunk at a time
+#[derive(Debug)]
+pub struct ChunkReader<R, T> {
+    input: R,
+    header: Header,
+    remaining: u64,
+    buf: Vec<u8>,
+    marker: core::marker::PhantomData<T>,
+}
+
+impl<R: Read, T: BinCoord> ChunkReader<R, T> {
+    pub fn new(mut input: R) -> io::Result<Self> {
+        let mut bytes = [0; HEADER_LEN];
+        input.read_exact(&mut bytes)?;
+        let header = Header::from_bytes(&bytes)?;
+        header.check_width::<T>()?;
+        Ok(Self {
+            input,
+            header,
+            remaining: header.count,
+            buf: Vec::new(),
+            marker: core::marker::PhantomData,
+        })
+    }
+
+    #[inline]
+    pub fn header(&self) -> &Header {
+        &self.header
+    }
+
+    /// Replace the contents of `out` by the next (at most) `max_len`
+    /// elements; returns how many were read, zero at the end of the input
+    pub fn next_chunk(&mut self, max_len: usize, out: &mut Vec<[T; 3]>) -> io::Result<usize> {
+        let n = self.remaining.min(max_len as u64) as usize;
+        let stride = self.header.stride();
+        self.buf.resize(n * stride, 0);
+        self.input.read_exact(&mut self.buf)?;
+        out.clear();
+        out.extend(self.buf.chunks_exact(stride).map(|bytes| decode(bytes)));
+        self.remaining -= n as u64;
+        Ok(n)
+    }
+}
+
+/**
+Apply `op` to every element of an encoded stream and encode the results
+
+At most `chunk_len` elements are held in memory at a time. The output has
+the geometry of the input, element kind `kind` and the coordinate type of
+`op`'s result, which may be wider than the input's. Returns the output
+header.
+
+Examples:
+
+```rust
+use projgeom_rs::pg_io::{map_stream, write_objects, CoordView, Geometry, Kind};
+use projgeom_rs::{reflect, HypLine, HypPoint};
+let pts: Vec<_> = (0..100).map(|i| HypPoint::new([i, 2 * i + 1, 3])).collect();
+let mut input = Vec::new();
+write_objects(&mut input, Kind::Point, Geometry::Hyp, &pts).unwrap();
+
+let mirror = HypLine::new([3, -1, 7]);
+let mut output = Vec::new();
+map_stream(&input[..], &mut output, Kind::Point, 16, |c: [i128; 3]| {
+    reflect(&mirror, &HypPoint::new(c))
+})
+.unwrap();
+let view = CoordView::<i128>::new(&output).unwrap();
+assert_eq!(view.len(), 100);
+assert_eq!(view.get(42), reflect(&mirror, &pts[42]).coord);
+```
+*/
+pub fn map_stream<R, W, T, U, O, F>(
+    input: R,
+    output: &mut W,
+    kind: Kind,
+    chunk_len: usize,
+    mut op: F,
+) -> io::Result<Header>
+where
+    R: Read,
+    W: Write,
+    T: BinCoord,
+    U: BinCoord,
+    O: AsRef<[U; 3]>,
+    F: FnMut([T; 3]) -> O,
+{
+    assert!(chunk_len > 0);
+    let mut reader = ChunkReader::<R, T>::new(input)?;
+    let header = Header::new::<U>(kind, reader.header().geometry, reader.header().count);
+    output.write_all(&header.to_bytes())?;
+    let mut chunk = Vec::with_capacity(chunk_len);
+    let mut buf = Vec::with_capacity(chunk_len * header.stride());
+    while reader.next_chunk(chunk_len, &mut chunk)? != 0 {
+        buf.clear();
+        chunk.iter().for_each(|c| encode(op(*c).as_ref(), &mut buf));
+        output.write_all(&buf)?;
+    }
+    Ok(header)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ck_plane::reflect;
+    use crate::pg_object::{MyCKLine, MyCKPoint, PgLine, PgPoint, PgPointT};
+    use crate::pg_plane::{involution, ProjPlanePrim};
+
+    #[test]
+    fn test_round_trip() {
+        let pts: Vec<PgPointT<i32>> = (0..1000)
+            .map(|i| PgPointT::new([i, -3 * i, i32::MAX - i]))
+            .collect();
+        let mut buf = Vec::new();
+        write_objects(&mut buf, Kind::Point, Geometry::Pg, &pts).unwrap();
+        assert_eq!(buf.len(), HEADER_LEN + 12 * pts.len());
+
+        let view = CoordView::<i32>::new(&buf).unwrap();
+        assert_eq!(view.header().geometry, Geometry::Pg);
+        assert!(view.iter().eq(pts.iter().map(|p| p.coord)));
+        assert!(CoordView::<i64>::new(&buf).is_err());
+        assert!(CoordView::<i32>::new(&buf[..buf.len() - 1]).is_err());
+
+        let mut reader = ChunkReader::<_, i32>::new(&buf[..]).unwrap();
+        let (mut chunk, mut seen) = (Vec::new(), 0);
+        while reader.next_chunk(300, &mut chunk).unwrap() != 0 {
+            assert!(chunk.len() <= 300);
+            assert!(chunk.iter().zip(&pts[seen..]).all(|(c, p)| *c == p.coord));
+            seen += chunk.len();
+        }
+        assert_eq!(seen, pts.len());
+    }
+
+    #[test]
+    fn test_map_stream() {
+        let pts: Vec<PgPointT<i32>> = (0..257).map(|i| PgPointT::new([i, i % 7 - 3, 5])).collect();
+        let mut input = Vec::new();
+        write_objects(&mut input, Kind::Point, Geometry::Pg, &pts).unwrap();
+
+        // joins with a fixed point, widened to i128 on the way
+        let o = PgPoint::new([1, 1, 1]);
+        let mut output = Vec::new();
+        let header = map_stream(&input[..], &mut output, Kind::Line, 10, |c: [i32; 3]| {
+            o.circ(&PgPoint::new(c.map(i128::from)))
+        })
+        .unwrap();
+        assert_eq!(header, Header::new::<i128>(Kind::Line, Geometry::Pg, 257));
+        let view = CoordView::<i128>::new(&output).unwrap();
+        for (i, c) in view.iter().enumerate() {
+            let l = PgLine::new(c);
+            assert!(l.incident(&o) && l.incident(&PgPoint::new(pts[i].coord.map(i128::from))));
+        }
+
+        let mirror = MyCKLine::new([3, -1, 7]);
+        let origin = MyCKPoint::new([1, 1, 5]);
+        let pts: Vec<MyCKPoint> = (0..50).map(|i| MyCKPoint::new([i, 2, i - 9])).collect();
+        let mut input = Vec::new();
+        write_objects(&mut input, Kind::Point, Geometry::MyCK, &pts).unwrap();
+        let mut output = Vec::new();
+        map_stream(&input[..], &mut output, Kind::Point, 7, |c: [i128; 3]| {
+            involution(&origin, &mirror, &reflect(&mirror, &MyCKPoint::new(c)))
+        })
+        .unwrap();
+        let view = CoordView::<i128>::new(&output).unwrap();
+        assert_eq!(view.header().geometry, Geometry::MyCK);
+        for (p, c) in pts.iter().zip(view.iter()) {
+            assert_eq!(c, involution(&origin, &mirror, &reflect(&mirror, p)).coord);
+        }
+    }
+}
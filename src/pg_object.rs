@@ -1,6 +1,92 @@
-use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+use crate::metrics::{self, Op};
+use core::fmt::Debug;
+use core::ops::Neg;
+use num_integer::{gcd, Integer};
+use num_traits::{Num, PrimInt, Signed};
 // use crate::pg_plane::{check_axiom, coincident};
 
+/**
+ * Coordinate scalar of the homogeneous points and lines
+ *
+ * `i128` is the default; `i64`/`i32` suit bounded coordinates and
+ * `f32`/`f64` suit the floating-point front end.
+ */
+pub trait Scalar: Copy + Default + PartialEq + Debug + Num + Neg<Output = Self> {
+    const ZERO: Self;
+    const ONE: Self;
+    const NEG_ONE: Self;
+
+    /// Incidence test `a . b == 0`, used by every `incident`
+    #[inline]
+    fn dot_is_zero(a: &[Self; 3], b: &[Self; 3]) -> bool {
+        dot(a, b) == Self::ZERO
+    }
+
+    /// `N`-term counterpart of `dot_is_zero`, used by the space predicates
+    #[inline]
+    fn dot_n_is_zero<const N: usize>(a: &[Self; N], b: &[Self; N]) -> bool {
+        (0..N).fold(Self::ZERO, |acc, i| acc + a[i] * b[i]) == Self::ZERO
+    }
+
+    /// Bit length of the magnitude for the `metrics` histograms; zero for
+    /// non-integer scalars
+    #[inline]
+    fn bit_len(&self) -> u32 {
+        0
+    }
+}
+
+macro_rules! impl_scalar {
+    ($($scalar:ident),*) => (
+        $(
+            impl Scalar for $scalar {
+                const ZERO: Self = 0 as $scalar;
+                const ONE: Self = 1 as $scalar;
+                const NEG_ONE: Self = -1 as $scalar;
+            }
+        )*
+    );
+}
+
+macro_rules! impl_scalar_int {
+    ($($scalar:ident),*) => (
+        $(
+            impl Scalar for $scalar {
+                const ZERO: Self = 0;
+                const ONE: Self = 1;
+                const NEG_ONE: Self = -1;
+
+                #[inline]
+                fn bit_len(&self) -> u32 {
+                    $scalar::BITS - self.unsigned_abs().leading_zeros()
+                }
+            }
+        )*
+    );
+}
+
+impl_scalar_int!(i8, i16, i32, i64, i128, isize);
+impl_scalar!(f32);
+
+impl Scalar for f64 {
+    const ZERO: Self = 0.0;
+    const ONE: Self = 1.0;
+    const NEG_ONE: Self = -1.0;
+
+    /// Sign of the exact dot product of the (rounded) coordinates, see
+    /// `robust::dot_sign`
+    #[inline]
+    fn dot_is_zero(a: &[Self; 3], b: &[Self; 3]) -> bool {
+        crate::robust::dot_sign(a, b) == core::cmp::Ordering::Equal
+    }
+
+    /// See `robust::dot_sign_n`
+    #[inline]
+    fn dot_n_is_zero<const N: usize>(a: &[Self; N], b: &[Self; N]) -> bool {
+        crate::robust::dot_sign_n(a, b) == core::cmp::Ordering::Equal
+    }
+}
+
 /**
 Dot product
 
@@ -13,7 +99,7 @@ assert_eq!(a, 26);
 ```
 */
 #[inline]
-pub fn dot(a: &[i128; 3], b: &[i128; 3]) -> i128 {
+pub fn dot<T: Scalar>(a: &[T; 3], b: &[T; 3]) -> T {
     a[0] * b[0] + a[1] * b[1] + a[2] * b[2]
 }
 
@@ -29,7 +115,7 @@ assert_eq!(a, 26);
 ```
 */
 #[inline]
-pub fn dot1(a: &[i128], b: &[i128]) -> i128 {
+pub fn dot1<T: Scalar>(a: &[T], b: &[T]) -> T {
     a[0] * b[0] + a[1] * b[1]
 }
 
@@ -45,7 +131,7 @@ assert_eq!(a, -2);
 ```
 */
 #[inline]
-pub fn cross2(a: &[i128], b: &[i128]) -> i128 {
+pub fn cross2<T: Scalar>(a: &[T], b: &[T]) -> T {
     a[0] * b[1] - a[1] * b[0]
 }
 
@@ -61,7 +147,7 @@ assert_eq!(a, [-2, 4, -2]);
 ```
 */
 #[inline]
-pub fn cross(a: &[i128; 3], b: &[i128; 3]) -> [i128; 3] {
+pub fn cross<T: Scalar>(a: &[T; 3], b: &[T; 3]) -> [T; 3] {
     [
         a[1] * b[2] - a[2] * b[1],
         a[2] * b[0] - a[0] * b[2],
@@ -81,7 +167,170 @@ assert_eq!(a, [-2, -2, -2]);
 ```
 */
 #[inline]
-pub fn plckr(ld: &i128, p: &[i128; 3], mu: &i128, q: &[i128; 3]) -> [i128; 3] {
+pub fn plckr<T: Scalar>(ld: &T, p: &[T; 3], mu: &T, q: &[T; 3]) -> [T; 3] {
+    [
+        *ld * p[0] + *mu * q[0],
+        *ld * p[1] + *mu * q[1],
+        *ld * p[2] + *mu * q[2],
+    ]
+}
+
+/**
+Normalize homogeneous coordinates to a canonical form
+
+The coordinates are divided by their greatest common divisor and the
+first non-zero coordinate is made positive. Returns the divisor.
+
+Examples:
+
+```rust
+use projgeom_rs::pg_object::normalize_coord;
+let mut c = [-4, 6, 10];
+assert_eq!(normalize_coord(&mut c), -2);
+assert_eq!(c, [2, -3, -5]);
+```
+*/
+#[inline]
+pub fn normalize_coord<T: Scalar + Integer, const N: usize>(coord: &mut [T; N]) -> T {
+    metrics::count(Op::Normalize);
+    canonical_coord(coord)
+}
+
+/// `normalize_coord` without the `Op::Normalize` count, for hashing
+#[inline]
+pub(crate) fn canonical_coord<T: Scalar + Integer, const N: usize>(coord: &mut [T; N]) -> T {
+    let mut common = coord.iter().fold(T::ZERO, |g, c| gcd(g, *c));
+    let lead = coord.iter().find(|c| **c != T::ZERO);
+    if let Some(c) = lead {
+        if *c < T::ZERO {
+            common = -common;
+        }
+    }
+    if common != T::ONE && common != T::ZERO {
+        for c in coord.iter_mut() {
+            *c = *c / common;
+        }
+    }
+    common
+}
+
+/**
+Bit length of the largest coordinate in magnitude
+
+Examples:
+
+```rust
+use projgeom_rs::pg_object::magnitude_bits;
+assert_eq!(magnitude_bits(&[3, -8, 0]), 4);
+assert_eq!(magnitude_bits(&[0, 0, 0]), 0);
+```
+*/
+#[inline]
+pub fn magnitude_bits<T: PrimInt + Signed, const N: usize>(coord: &[T; N]) -> u32 {
+    let m = coord.iter().fold(T::zero(), |m, c| m | c.abs());
+    T::zero().count_zeros() - m.leading_zeros()
+}
+
+/// Projective normalization of a point or line (see `normalize_coord`)
+pub trait Normalize {
+    fn normalize(&mut self);
+    fn magnitude_bits(&self) -> u32;
+}
+
+/**
+Harmonic conjugate of `c` with respect to `a` and `b` (fused kernel)
+
+With `c = ld a + mu b` the conjugate is `ld a - mu b`. Writing
+`u = a x b` gives `c x b = ld u` and `c x a = -mu u`, so for any
+component `k` with `u[k] != 0` the result is, up to the scale `u[k]`,
+`(c x b)[k] a + (c x a)[k] b`. This takes 16 multiplies (4 besides the
+cross product and the Plucker step) and keeps the result at degree 3.
+
+Examples:
+
+```rust
+use projgeom_rs::pg_object::harm_conj_coord;
+let d = harm_conj_coord(&[1, 0, 0], &[0, 1, 0], &[1, 1, 0], &[0, 0, 1]);
+assert_eq!(d, [1, -1, 0]);
+```
+*/
+#[inline]
+pub fn harm_conj_coord<T: Scalar>(a: &[T; 3], b: &[T; 3], c: &[T; 3], u: &[T; 3]) -> [T; 3] {
+    let k = if u[2] != T::ZERO {
+        2
+    } else if u[0] != T::ZERO {
+        0
+    } else {
+        1
+    };
+    let (i, j) = ((k + 1) % 3, (k + 2) % 3);
+    let ld = c[i] * b[j] - c[j] * b[i];
+    let mu = c[i] * a[j] - c[j] * a[i];
+    let res = plckr(&ld, a, &mu, b);
+    metrics::count(Op::Plucker); // counted as the Plucker step it ends in
+    metrics::record(&res);
+    res
+}
+
+/// `harm_conj_coord` of `c`, or `None` if `a`, `b` and `c` are not collinear
+#[inline]
+pub fn try_harm_conj_coord<T: Scalar>(a: &[T; 3], b: &[T; 3], c: &[T; 3]) -> Option<[T; 3]> {
+    let u = cross(a, b);
+    if !T::dot_is_zero(&u, c) {
+        return None; // !coincident(a, b, c)
+    }
+    Some(harm_conj_coord(a, b, c, &u))
+}
+
+/**
+Dot product of i128 coordinates, usable in constants
+
+Examples:
+
+```rust
+use projgeom_rs::pg_object::dot_const;
+const A: i128 = dot_const(&[1, 2, 3], &[3, 4, 5]);
+assert_eq!(A, 26);
+```
+*/
+#[inline]
+pub const fn dot_const(a: &[i128; 3], b: &[i128; 3]) -> i128 {
+    a[0] * b[0] + a[1] * b[1] + a[2] * b[2]
+}
+
+/**
+Cross product of i128 coordinates, usable in constants
+
+Examples:
+
+```rust
+use projgeom_rs::pg_object::cross_const;
+const A: [i128; 3] = cross_const(&[1, 2, 3], &[3, 4, 5]);
+assert_eq!(A, [-2, 4, -2]);
+```
+*/
+#[inline]
+pub const fn cross_const(a: &[i128; 3], b: &[i128; 3]) -> [i128; 3] {
+    [
+        a[1] * b[2] - a[2] * b[1],
+        a[2] * b[0] - a[0] * b[2],
+        a[0] * b[1] - a[1] * b[0],
+    ]
+}
+
+/**
+Plucker operation on i128 coordinates, usable in constants
+
+Examples:
+
+```rust
+use projgeom_rs::pg_object::plckr_const;
+const A: [i128; 3] = plckr_const(1, &[1, 2, 3], -1, &[3, 4, 5]);
+assert_eq!(A, [-2, -2, -2]);
+```
+*/
+#[inline]
+pub const fn plckr_const(ld: i128, p: &[i128; 3], mu: i128, q: &[i128; 3]) -> [i128; 3] {
     [
         ld * p[0] + mu * q[0],
         ld * p[1] + mu * q[1],
@@ -89,59 +338,203 @@ pub fn plckr(ld: &i128, p: &[i128; 3], mu: &i128, q: &[i128; 3]) -> [i128; 3] {
     ]
 }
 
+/// Trait impls common to every coordinate type `$obj<$($g,)* T>`; the
+/// leading marker parameters `$g` are for types such as `ck_polarity`'s
+macro_rules! impl_coord_object {
+    ([$($g:ident),*] $obj:ident) => {
+        impl<$($g,)* T> AsRef<[T; 3]> for $obj<$($g,)* T> {
+            #[inline]
+            fn as_ref(&self) -> &[T; 3] {
+                &self.coord
+            }
+        }
+
+        impl<$($g,)* T> From<[T; 3]> for $obj<$($g,)* T> {
+            #[inline]
+            fn from(coord: [T; 3]) -> Self {
+                Self::new(coord)
+            }
+        }
+
+        impl<$($g,)* T: $crate::pg_object::Scalar> PartialEq for $obj<$($g,)* T> {
+            /// Projective equality: all 2x2 minors of the two coordinates
+            /// vanish. Each minor is checked in turn, so unequal objects
+            /// usually exit after the first pair of multiplies.
+            #[inline]
+            fn eq(&self, other: &Self) -> bool {
+                let (a, b) = (&self.coord, &other.coord);
+                a[0] * b[1] == a[1] * b[0]
+                    && a[1] * b[2] == a[2] * b[1]
+                    && a[0] * b[2] == a[2] * b[0]
+            }
+        }
+        impl<$($g,)* T: $crate::pg_object::Scalar> Eq for $obj<$($g,)* T> {}
+
+        impl<$($g,)* T> core::hash::Hash for $obj<$($g,)* T>
+        where
+            T: $crate::pg_object::Scalar + ::num_integer::Integer + core::hash::Hash,
+        {
+            /// Hashes the canonical form (see `normalize_coord`), so that
+            /// projectively equal objects hash alike. The degenerate zero
+            /// vector compares equal to everything and is not supported.
+            #[inline]
+            fn hash<H: core::hash::Hasher>(&self, state: &mut H) {
+                let mut coord = self.coord;
+                $crate::pg_object::canonical_coord(&mut coord);
+                coord.hash(state);
+            }
+        }
+
+        impl<$($g,)* T> $crate::pg_object::Normalize for $obj<$($g,)* T>
+        where
+            T: $crate::pg_object::Scalar
+                + ::num_integer::Integer
+                + ::num_traits::PrimInt
+                + ::num_traits::Signed,
+        {
+            #[inline]
+            fn normalize(&mut self) {
+                $crate::pg_object::normalize_coord(&mut self.coord);
+            }
+
+            #[inline]
+            fn magnitude_bits(&self) -> u32 {
+                $crate::pg_object::magnitude_bits(&self.coord)
+            }
+        }
+    };
+}
+pub(crate) use impl_coord_object;
+
+/// `ProjPlanePrim` and `ProjPlane` of `$point` with dual `$line`, both over
+/// the marker parameters `$g` (bounded by `$gb`) and the scalar `T`
+macro_rules! impl_line_for_point {
+    ([$($g:ident: $gb:path),*] $line:ident, $point:ident) => {
+        impl<$($g: $gb,)* T: $crate::pg_object::Scalar>
+            $crate::pg_plane::ProjPlane<$line<$($g,)* T>, T> for $point<$($g,)* T>
+        {
+            #[inline]
+            fn aux(&self) -> $line<$($g,)* T> {
+                $line::new(self.coord)
+            }
+
+            #[inline]
+            fn dot(&self, line: &$line<$($g,)* T>) -> T {
+                $crate::metrics::count($crate::metrics::Op::Dot);
+                $crate::pg_object::dot(&self.coord, &line.coord)
+            } // basic measurement
+
+            #[inline]
+            fn plucker(&self, ld: &T, q: &Self, mu: &T) -> Self {
+                let res = $crate::pg_object::plckr(ld, &self.coord, mu, &q.coord);
+                $crate::metrics::count($crate::metrics::Op::Plucker);
+                $crate::metrics::record(&res);
+                Self::new(res)
+            }
+
+            #[inline]
+            fn try_harm_conj(&self, b: &Self, c: &Self) -> Option<Self> {
+                $crate::pg_object::try_harm_conj_coord(&self.coord, &b.coord, &c.coord)
+                    .map(Self::new)
+            }
+
+            #[inline]
+            fn harm_conj_unchecked(&self, b: &Self, c: &Self) -> Self {
+                let u = $crate::pg_object::cross(&self.coord, &b.coord);
+                debug_assert!(T::dot_is_zero(&u, &c.coord)); // coincident(self, b, c)
+                Self::new($crate::pg_object::harm_conj_coord(
+                    &self.coord,
+                    &b.coord,
+                    &c.coord,
+                    &u,
+                ))
+            }
+
+            #[inline]
+            fn involution(&self, mirror: &$line<$($g,)* T>, p: &Self) -> Self {
+                // `po` spans the origin, `b` and `p`, so it stands in for
+                // `origin x b` and the collinearity check can be skipped
+                let po = $crate::pg_object::cross(&p.coord, &self.coord);
+                let b = $crate::pg_object::cross(&po, &mirror.coord);
+                Self::new($crate::pg_object::harm_conj_coord(
+                    &self.coord,
+                    &b,
+                    &p.coord,
+                    &po,
+                ))
+            }
+        }
+
+        impl<$($g: $gb,)* T: $crate::pg_object::Scalar>
+            $crate::pg_plane::ProjPlanePrim<$line<$($g,)* T>> for $point<$($g,)* T>
+        {
+            #[inline]
+            fn incident(&self, line: &$line<$($g,)* T>) -> bool {
+                $crate::metrics::count($crate::metrics::Op::Incident);
+                T::dot_is_zero(&self.coord, &line.coord)
+            }
+
+            #[inline]
+            fn circ(&self, rhs: &Self) -> $line<$($g,)* T> {
+                let res = $crate::pg_object::cross(&self.coord, &rhs.coord);
+                $crate::metrics::count($crate::metrics::Op::Circ);
+                $crate::metrics::record(&res);
+                $line::new(res)
+            }
+        }
+    };
+}
+pub(crate) use impl_line_for_point;
+
 macro_rules! define_point_or_line {
     (impl $point:ident) => {
-        #[derive(Debug, Clone)]
-        pub struct $point {
+        #[derive(Debug, Clone, Copy)]
+        pub struct $point<T> {
             /// Homogeneous coordinate
-            pub coord: [i128; 3],
+            pub coord: [T; 3],
         }
 
-        impl $point {
+        impl<T> $point<T> {
             #[inline]
-            pub fn new(coord: [i128; 3]) -> Self {
+            pub const fn new(coord: [T; 3]) -> Self {
                 Self { coord }
             }
         }
 
-        impl PartialEq for $point {
-            #[inline]
-            fn eq(&self, other: &$point) -> bool {
-                cross(&self.coord, &other.coord) == [0, 0, 0]
-            }
-        }
-        impl Eq for $point {}
+        impl_coord_object!([] $point);
     };
 }
 
 macro_rules! define_line_for_point {
     (impl $line:ident, $point:ident) => {
-        impl ProjPlane<$line, i128> for $point {
+        impl_line_for_point!([] $line, $point);
+
+        /// `const` counterparts of the trait methods for i128 coordinates,
+        /// so that fixed configurations can be built at compile time
+        impl $point<i128> {
             #[inline]
-            fn aux(&self) -> $line {
-                $line::new(self.coord.clone())
+            pub const fn circ_const(&self, rhs: &Self) -> $line<i128> {
+                $line::new(cross_const(&self.coord, &rhs.coord))
             }
 
             #[inline]
-            fn dot(&self, line: &$line) -> i128 {
-                dot(&self.coord, &line.coord)
-            } // basic measurement
+            pub const fn incident_const(&self, line: &$line<i128>) -> bool {
+                dot_const(&self.coord, &line.coord) == 0
+            }
 
             #[inline]
-            fn plucker(&self, ld: &i128, q: &Self, mu: &i128) -> Self {
-                Self::new(plckr(ld, &self.coord, mu, &q.coord))
+            pub const fn aux_const(&self) -> $line<i128> {
+                $line::new(self.coord)
             }
-        }
 
-        impl ProjPlanePrim<$line> for $point {
             #[inline]
-            fn incident(&self, _rhs: &$line) -> bool {
-                dot(&self.coord, &_rhs.coord) == 0
+            pub const fn dot_const(&self, line: &$line<i128>) -> i128 {
+                dot_const(&self.coord, &line.coord)
             }
 
             #[inline]
-            fn circ(&self, _rhs: &Self) -> $line {
-                $line::new(cross(&self.coord, &_rhs.coord))
+            pub const fn plucker_const(&self, ld: i128, q: &Self, mu: i128) -> Self {
+                Self::new(plckr_const(ld, &self.coord, mu, &q.coord))
             }
         }
     };
@@ -156,10 +549,23 @@ macro_rules! define_point_and_line {
     };
 }
 
-define_point_and_line!(impl PgPoint, PgLine);
-define_point_and_line!(impl HypPoint, HypLine);
-define_point_and_line!(impl EllPoint, EllLine);
-define_point_and_line!(impl MyCKPoint, MyCKLine);
-define_point_and_line!(impl PerspPoint, PerspLine);
-define_point_and_line!(impl EuclidPoint, EuclidLine);
+define_point_and_line!(impl PgPointT, PgLineT);
+define_point_and_line!(impl HypPointT, HypLineT);
+define_point_and_line!(impl EllPointT, EllLineT);
+define_point_and_line!(impl MyCKPointT, MyCKLineT);
+define_point_and_line!(impl PerspPointT, PerspLineT);
+define_point_and_line!(impl EuclidPointT, EuclidLineT);
 // You may add your own geometry here
+
+pub type PgPoint = PgPointT<i128>;
+pub type PgLine = PgLineT<i128>;
+pub type HypPoint = HypPointT<i128>;
+pub type HypLine = HypLineT<i128>;
+pub type EllPoint = EllPointT<i128>;
+pub type EllLine = EllLineT<i128>;
+pub type MyCKPoint = MyCKPointT<i128>;
+pub type MyCKLine = MyCKLineT<i128>;
+pub type PerspPoint = PerspPointT<i128>;
+pub type PerspLine = PerspLineT<i128>;
+pub type EuclidPoint = EuclidPointT<i128>;
+pub type EuclidLine = EuclidLineT<i128>;
@@ -0,0 +1,236 @@
+// Data-parallel constructions (feature `parallel`)
+//
+// Slice-level versions of the scalar constructions, scheduled on rayon's
+// work-stealing pool. Every element is independent, so the inputs are split
+// into runs of at least `MIN_LEN` elements; inputs shorter than that are
+// evaluated on the calling thread and never touch the pool.
+
+use crate::ck_plane::{orthocenter, reflect, CKPlane, CKPlanePrim};
+use crate::pg_batch::{cross_many, dot_many, incident_many};
+use crate::pg_object::Scalar;
+use crate::pg_plane::ProjPlanePrim;
+use rayon::prelude::*;
+
+/// Smallest amount of work handed to a worker thread
+pub const MIN_LEN: usize = 1024;
+
+/**
+Element-wise join (or meet): `ps[i].circ(&qs[i])`
+
+Examples:
+
+```rust
+use projgeom_rs::pg_parallel::par_circ;
+use projgeom_rs::{PgLine, PgPoint, ProjPlanePrim};
+let ps = vec![PgPoint::new([1, 3, 2]); 3000];
+let qs = vec![PgPoint::new([-2, 1, -1]); 3000];
+let ls: Vec<PgLine> = par_circ(&ps, &qs);
+assert!(ls.iter().all(|l| l.incident(&ps[0])));
+```
+*/
+pub fn par_circ<P, L>(ps: &[P], qs: &[P]) -> Vec<L>
+where
+    P: ProjPlanePrim<L> + Sync,
+    L: Send,
+{
+    assert_eq!(ps.len(), qs.len());
+    if ps.len() < MIN_LEN {
+        return ps.iter().zip(qs).map(|(p, q)| p.circ(q)).collect();
+    }
+    ps.par_iter()
+        .zip(qs)
+        .with_min_len(MIN_LEN)
+        .map(|(p, q)| p.circ(q))
+        .collect()
+}
+
+/// Element-wise incidence: `ps[i].incident(&ls[i])`
+pub fn par_incident<P, L>(ps: &[P], ls: &[L]) -> Vec<bool>
+where
+    P: ProjPlanePrim<L> + Sync,
+    L: Sync,
+{
+    assert_eq!(ps.len(), ls.len());
+    if ps.len() < MIN_LEN {
+        return ps.iter().zip(ls).map(|(p, l)| p.incident(l)).collect();
+    }
+    ps.par_iter()
+        .zip(ls)
+        .with_min_len(MIN_LEN)
+        .map(|(p, l)| p.incident(l))
+        .collect()
+}
+
+/// Incidence of every element with a single line
+pub fn par_incident_with<P, L>(ps: &[P], line: &L) -> Vec<bool>
+where
+    P: ProjPlanePrim<L> + Sync,
+    L: Sync,
+{
+    if ps.len() < MIN_LEN {
+        return ps.iter().map(|p| p.incident(line)).collect();
+    }
+    ps.par_iter()
+        .with_min_len(MIN_LEN)
+        .map(|p| p.incident(line))
+        .collect()
+}
+
+/// Orthocenter of every triangle
+pub fn par_orthocenter<P, L>(tris: &[[P; 3]]) -> Vec<P>
+where
+    P: CKPlanePrim<L> + Send + Sync,
+    L: CKPlanePrim<P>,
+{
+    if tris.len() < MIN_LEN {
+        return tris.iter().map(orthocenter).collect();
+    }
+    tris.par_iter()
+        .with_min_len(MIN_LEN)
+        .map(orthocenter)
+        .collect()
+}
+
+/// Reflection of every point about the same mirror
+pub fn par_reflect<P, L, V>(mirror: &L, ps: &[P]) -> Vec<P>
+where
+    V: Default + PartialEq,
+    P: CKPlane<L, V> + Send + Sync,
+    L: CKPlane<P, V> + Sync,
+{
+    if ps.len() < MIN_LEN {
+        return ps.iter().map(|p| reflect(mirror, p)).collect();
+    }
+    ps.par_iter()
+        .with_min_len(MIN_LEN)
+        .map(|p| reflect(mirror, p))
+        .collect()
+}
+
+#[inline]
+fn sub_columns<T>(cols: [&[T]; 3], start: usize, len: usize) -> [&[T]; 3] {
+    cols.map(|c| &c[start..start + len])
+}
+
+/// Parallel version of [`cross_many`](crate::pg_batch::cross_many)
+pub fn par_cross_many<T>(a: [&[T]; 3], b: [&[T]; 3], out: [&mut [T]; 3])
+where
+    T: Scalar + Send + Sync,
+{
+    let n = out[0].len();
+    if n < MIN_LEN {
+        return cross_many(a, b, out);
+    }
+    let [ox, oy, oz] = out;
+    ox[..n]
+        .par_chunks_mut(MIN_LEN)
+        .zip(oy[..n].par_chunks_mut(MIN_LEN))
+        .zip(oz[..n].par_chunks_mut(MIN_LEN))
+        .enumerate()
+        .for_each(|(k, ((x, y), z))| {
+            let (start, len) = (k * MIN_LEN, x.len());
+            cross_many(
+                sub_columns(a, start, len),
+                sub_columns(b, start, len),
+                [x, y, z],
+            );
+        });
+}
+
+/// Parallel version of [`dot_many`](crate::pg_batch::dot_many)
+pub fn par_dot_many<T>(a: [&[T]; 3], b: [&[T]; 3], out: &mut [T])
+where
+    T: Scalar + Send + Sync,
+{
+    if out.len() < MIN_LEN {
+        return dot_many(a, b, out);
+    }
+    out.par_chunks_mut(MIN_LEN)
+        .enumerate()
+        .for_each(|(k, res)| {
+            let (start, len) = (k * MIN_LEN, res.len());
+            dot_many(sub_columns(a, start, len), sub_columns(b, start, len), res);
+        });
+}
+
+/// Parallel version of [`incident_many`](crate::pg_batch::incident_many)
+pub fn par_incident_many<T>(a: [&[T]; 3], b: [&[T]; 3], out: &mut [bool])
+where
+    T: Scalar + Send + Sync,
+{
+    if out.len() < MIN_LEN {
+        return incident_many(a, b, out);
+    }
+    out.par_chunks_mut(MIN_LEN)
+        .enumerate()
+        .for_each(|(k, res)| {
+            let (start, len) = (k * MIN_LEN, res.len());
+            incident_many(sub_columns(a, start, len), sub_columns(b, start, len), res);
+        });
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_batch::{HypPointBatch, PgPointBatch};
+    use crate::pg_object::{HypLine, HypPoint, PgLine, PgPoint};
+
+    fn points<P>(n: usize, seed: i128, new: fn([i128; 3]) -> P) -> Vec<P> {
+        (0..n as i128)
+            .map(|i| new([i % 97 + seed, (i * seed) % 89 - 40, (i * 13) % 83 + 1]))
+            .collect()
+    }
+
+    #[test]
+    fn test_par_matches_sequential() {
+        for n in [10, 3 * MIN_LEN + 17] {
+            let ps = points(n, 1, PgPoint::new);
+            let qs = points(n, 5, PgPoint::new);
+            let ls: Vec<PgLine> = par_circ(&ps, &qs);
+            for i in 0..n {
+                assert_eq!(ls[i].coord, ps[i].circ(&qs[i]).coord);
+            }
+            assert!(par_incident(&ps, &ls).iter().all(|b| *b));
+            assert_eq!(
+                par_incident_with(&ps, &ls[0]),
+                ps.iter().map(|p| p.incident(&ls[0])).collect::<Vec<_>>()
+            );
+
+            let (pb, qb) = (PgPointBatch::from_slice(&ps), PgPointBatch::from_slice(&qs));
+            assert_eq!(pb.par_circ_many(&qb), pb.circ_many(&qb));
+            assert!(pb
+                .par_incident_mask(&pb.par_circ_many(&qb))
+                .iter()
+                .all(|b| *b));
+        }
+    }
+
+    #[test]
+    fn test_par_ck() {
+        let n = 2 * MIN_LEN + 3;
+        let (a, b, c) = (
+            points(n, 1, HypPoint::new),
+            points(n, 5, HypPoint::new),
+            points(n, -9, HypPoint::new),
+        );
+        let tris: Vec<[HypPoint; 3]> = (0..n)
+            .map(|i| [a[i], b[i], c[i]])
+            .filter(|[p, q, r]| !crate::pg_plane::coincident(p, q, r))
+            .collect();
+        assert!(tris.len() > MIN_LEN);
+        let os = par_orthocenter(&tris);
+        for (o, tri) in os.iter().zip(&tris) {
+            assert_eq!(o.coord, orthocenter(tri).coord);
+        }
+
+        let mirror = HypLine::new([3, -1, 7]);
+        let rs = par_reflect(&mirror, &a);
+        for (r, p) in rs.iter().zip(&a) {
+            assert_eq!(r.coord, reflect(&mirror, p).coord);
+        }
+        let (pa, pb) = (HypPointBatch::from_slice(&a), HypPointBatch::from_slice(&b));
+        let ls = pa.par_circ_many(&pb);
+        assert_eq!(ls, pa.circ_many(&pb));
+        assert_eq!(pa.par_dot_many(&ls), vec![0; n]);
+    }
+}
@@ -1,3 +1,5 @@
+use crate::pg_object::{cross, Scalar};
+
 pub trait ProjPlanePrim<L>: Eq {
     fn circ(&self, rhs: &Self) -> L; // join or meet
     fn incident(&self, line: &L) -> bool; // incidence
@@ -48,13 +50,51 @@ where
  */
 #[inline]
 pub fn tri_dual<P, L>(tri: &[P; 3]) -> [L; 3]
+where
+    P: ProjPlanePrim<L>,
+    L: ProjPlanePrim<P>,
+{
+    try_tri_dual(tri).expect("tri_dual: degenerate triangle")
+}
+
+/**
+Sides of a triangle, or `None` if its vertices are collinear
+
+Examples:
+
+```rust
+use projgeom_rs::{try_tri_dual, PgLine, PgPoint};
+let tri = [[0, 0, 1], [1, 0, 1], [0, 1, 1]].map(PgPoint::new);
+assert!(try_tri_dual::<_, PgLine>(&tri).is_some());
+let flat = [[0, 0, 1], [1, 1, 1], [2, 2, 1]].map(PgPoint::new);
+assert!(try_tri_dual::<_, PgLine>(&flat).is_none());
+```
+*/
+#[inline]
+pub fn try_tri_dual<P, L>(tri: &[P; 3]) -> Option<[L; 3]>
 where
     P: ProjPlanePrim<L>,
     L: ProjPlanePrim<P>,
 {
     let [a1, a2, a3] = tri;
-    assert!(!coincident(a1, a2, a3));
-    [a2.circ(a3), a1.circ(a3), a1.circ(a2)]
+    let l1 = a2.circ(a3);
+    if l1.incident(a1) {
+        return None; // coincident(a1, a2, a3)
+    }
+    Some([l1, a1.circ(a3), a1.circ(a2)])
+}
+
+/// `tri_dual` for a triangle known to be non-degenerate (checked in debug builds only)
+#[inline]
+pub fn tri_dual_unchecked<P, L>(tri: &[P; 3]) -> [L; 3]
+where
+    P: ProjPlanePrim<L>,
+    L: ProjPlanePrim<P>,
+{
+    let [a1, a2, a3] = tri;
+    let l1 = a2.circ(a3);
+    debug_assert!(!l1.incident(a1)); // !coincident(a1, a2, a3)
+    [l1, a1.circ(a3), a1.circ(a2)]
 }
 
 /**
@@ -88,16 +128,66 @@ where
     (b1 && b2) || (!b1 && !b2)
 }
 
-pub trait ProjPlane<L, V: Default + Eq>: ProjPlanePrim<L> {
+pub trait ProjPlane<L, V: Default + PartialEq>: ProjPlanePrim<L> {
     fn aux(&self) -> L; // line not incident with P
     fn dot(&self, line: &L) -> V; // for basic measurement
     fn plucker(&self, ld: &V, q: &Self, mu: &V) -> Self;
+
+    /// See `harm_conj`
+    #[inline]
+    fn harm_conj(&self, b: &Self, c: &Self) -> Self
+    where
+        Self: Sized,
+        L: ProjPlane<Self, V>,
+    {
+        self.try_harm_conj(b, c)
+            .expect("harm_conj: points are not collinear")
+    }
+
+    /// See `try_harm_conj`; coordinate types override this with a fused kernel
+    #[inline]
+    fn try_harm_conj(&self, b: &Self, c: &Self) -> Option<Self>
+    where
+        Self: Sized,
+        L: ProjPlane<Self, V>,
+    {
+        if !coincident(self, b, c) {
+            return None;
+        }
+        Some(self.harm_conj_unchecked(b, c))
+    }
+
+    /// See `harm_conj_unchecked`; coordinate types override this with a fused kernel
+    #[inline]
+    fn harm_conj_unchecked(&self, b: &Self, c: &Self) -> Self
+    where
+        Self: Sized,
+        L: ProjPlane<Self, V>,
+    {
+        debug_assert!(coincident(self, b, c));
+        let ab = self.circ(b);
+        let lc = ab.aux().circ(c);
+        Self::plucker(self, &lc.dot(b), b, &lc.dot(self))
+    }
+
+    /// See `involution`; coordinate types override this with a fused kernel
+    #[inline]
+    fn involution(&self, mirror: &L, p: &Self) -> Self
+    where
+        Self: Sized,
+        L: ProjPlane<Self, V>,
+    {
+        let po = p.circ(self);
+        let b = po.circ(mirror);
+        // `b` lies on `po` by construction
+        self.harm_conj_unchecked(&b, p)
+    }
 }
 
 #[allow(dead_code)]
 pub fn check_axiom2<P, L, V>(p: &P, q: &P, l: &L, a: &V, b: &V)
 where
-    V: Default + Eq,
+    V: Default + PartialEq,
     P: ProjPlane<L, V>,
     L: ProjPlane<P, V>,
 {
@@ -128,27 +218,85 @@ where
 #[inline]
 pub fn harm_conj<P, L, V>(a: &P, b: &P, c: &P) -> P
 where
-    V: Default + Eq,
+    V: Default + PartialEq,
     P: ProjPlane<L, V>,
     L: ProjPlane<P, V>,
 {
-    assert!(coincident(a, b, c));
-    let ab = a.circ(b);
-    let lc = ab.aux().circ(c);
-    P::plucker(a, &lc.dot(b), b, &lc.dot(a))
+    a.harm_conj(b, c)
+}
+
+/**
+ * @brief harmonic conjugate, or `None` if `a`, `b` and `c` are not collinear
+ *
+ */
+#[inline]
+pub fn try_harm_conj<P, L, V>(a: &P, b: &P, c: &P) -> Option<P>
+where
+    V: Default + PartialEq,
+    P: ProjPlane<L, V>,
+    L: ProjPlane<P, V>,
+{
+    a.try_harm_conj(b, c)
+}
+
+/**
+ * @brief harmonic conjugate of collinear points (checked in debug builds only)
+ *
+ */
+#[inline]
+pub fn harm_conj_unchecked<P, L, V>(a: &P, b: &P, c: &P) -> P
+where
+    V: Default + PartialEq,
+    P: ProjPlane<L, V>,
+    L: ProjPlane<P, V>,
+{
+    a.harm_conj_unchecked(b, c)
 }
 
 #[allow(dead_code)]
 #[inline]
 pub fn involution<P, L, V>(origin: &P, mirror: &L, p: &P) -> P
 where
-    V: Default + Eq,
+    V: Default + PartialEq,
     P: ProjPlane<L, V>,
     L: ProjPlane<P, V>,
 {
-    let po = p.circ(origin);
-    let b = po.circ(mirror);
-    harm_conj(origin, &b, p)
+    origin.involution(mirror, p)
+}
+
+/**
+Cross ratio `(a, b; c, d)` of four collinear points as a ratio `(num, den)`
+
+`[ac][bd] / ([ad][bc])`, where `[xy]` is the determinant of `x` and `y`
+in a coordinate on their common line. For collinear `x` and `y`,
+`cross(x, y)` is a multiple of the line `l = cross(a, b)`, so `[xy]` is
+read off a component `k` with `l[k] != 0`; no division is needed and the
+terms stay of degree 4 in the coordinates. Dually, for four concurrent
+lines.
+
+Examples:
+
+```rust
+use projgeom_rs::{cross_ratio, harm_conj, PgPoint, ProjPlane};
+let (a, b) = (PgPoint::new([1, 3, 2]), PgPoint::new([-2, 1, -1]));
+let c = a.plucker(&2, &b, &5);
+let (num, den) = cross_ratio(&a, &b, &c, &harm_conj(&a, &b, &c));
+assert_eq!(num, -den);
+```
+*/
+#[inline]
+pub fn cross_ratio<P, L, V>(a: &P, b: &P, c: &P, d: &P) -> (V, V)
+where
+    V: Scalar,
+    P: ProjPlane<L, V> + AsRef<[V; 3]>,
+    L: ProjPlane<P, V>,
+{
+    let l = cross(a.as_ref(), b.as_ref());
+    let Some(k) = l.iter().position(|x| *x != V::ZERO) else {
+        return (V::ZERO, V::ZERO); // a == b
+    };
+    let det = |x: &P, y: &P| cross(x.as_ref(), y.as_ref())[k];
+    (det(a, c) * det(b, d), det(a, d) * det(b, c))
 }
 
 #[cfg(test)]
@@ -0,0 +1,998 @@
+// Projective 3-space
+//
+// Points and planes are `[T; 4]` (dual to each other, like points and lines
+// in the plane); lines are Plucker coordinates `[T; 6]`, ordered
+// `(01, 02, 03, 12, 13, 23)`. The join of two points `p`, `q` is the line
+// `l_ij = p_i q_j - p_j q_i`; the meet of two planes is computed the same
+// way in dual coordinates and converted with `dual_line`. A line acts on
+// planes by its Plucker matrix (the point where it meets the plane) and on
+// points by its dual matrix (the plane it spans with the point), so every
+// construction is a handful of 2x2 minors.
+//
+// The traits mirror the planar ones: `ProjSpacePrim` (incidence, join and
+// meet), `ProjSpace` (basic measurement and Plucker combinations) and
+// `CKSpacePrim`/`CKSpace` (polarity). One line type serves every geometry,
+// since the line joining two points does not depend on the metric.
+//
+// Four-component objects fill a 256-bit lane exactly for i64/f64, and the
+// batches below keep each component in its own column as `pg_batch` does.
+// Hashing, `Normalize` and the metrics counters work as for the planar
+// objects, so space objects can be interned and wrapped in `Reduced`.
+// The incidence predicates go through `Scalar::dot_is_zero` and
+// `Scalar::dot_n_is_zero`, so they are exact for f64 as in the plane.
+
+use crate::metrics::{self, Op};
+use crate::pg_object::{canonical_coord, magnitude_bits, normalize_coord, Normalize, Scalar};
+use core::hash::{Hash, Hasher};
+use num_integer::Integer;
+use num_traits::{PrimInt, Signed};
+
+pub trait ProjSpacePrim<H, L>: Eq {
+    fn incident(&self, dual: &H) -> bool; // point on plane
+    fn circ(&self, rhs: &Self) -> L; // join of points or meet of planes
+    fn circ_line(&self, line: &L) -> H; // plane through point and line, or point on plane and line
+    fn on_line(&self, line: &L) -> bool; // point on line, or plane through line
+}
+
+pub trait ProjSpace<H, L, V: Default + PartialEq>: ProjSpacePrim<H, L> {
+    fn aux(&self) -> H; // plane not incident with the point
+    fn dot(&self, dual: &H) -> V; // for basic measurement
+    fn plucker(&self, ld: &V, q: &Self, mu: &V) -> Self;
+}
+
+pub trait CKSpacePrim<H, L>: ProjSpacePrim<H, L> {
+    fn perp(&self) -> H;
+}
+
+pub trait CKSpace<H, L, V: Default + PartialEq>: ProjSpace<H, L, V> + CKSpacePrim<H, L> {}
+
+/**
+4-d dot product
+
+Examples:
+
+```rust
+use projgeom_rs::pg_space::dot4;
+assert_eq!(dot4(&[1, 2, 3, 4], &[4, 3, -2, 1]), 8);
+```
+*/
+#[inline]
+pub fn dot4<T: Scalar>(a: &[T; 4], b: &[T; 4]) -> T {
+    a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]
+}
+
+/**
+Plucker coordinates of the line joining `a` and `b`
+
+Examples:
+
+```rust
+use projgeom_rs::pg_space::wedge;
+assert_eq!(wedge(&[1, 0, 0, 0], &[0, 1, 0, 0]), [1, 0, 0, 0, 0, 0]);
+```
+*/
+#[inline]
+pub fn wedge<T: Scalar>(a: &[T; 4], b: &[T; 4]) -> [T; 6] {
+    [
+        a[0] * b[1] - a[1] * b[0],
+        a[0] * b[2] - a[2] * b[0],
+        a[0] * b[3] - a[3] * b[0],
+        a[1] * b[2] - a[2] * b[1],
+        a[1] * b[3] - a[3] * b[1],
+        a[2] * b[3] - a[3] * b[2],
+    ]
+}
+
+/// Dual Plucker coordinates: the same line given by a pair of planes
+#[inline]
+pub fn dual_line<T: Scalar>(l: &[T; 6]) -> [T; 6] {
+    [l[5], -l[4], l[3], l[2], -l[1], l[0]]
+}
+
+/// Plucker matrix times `x`: for `l = p ^ q`, `p (q . x) - q (p . x)`
+#[inline]
+pub fn line_apply<T: Scalar>(l: &[T; 6], x: &[T; 4]) -> [T; 4] {
+    [
+        l[0] * x[1] + l[1] * x[2] + l[2] * x[3],
+        -l[0] * x[0] + l[3] * x[2] + l[4] * x[3],
+        -l[1] * x[0] - l[3] * x[1] + l[5] * x[3],
+        -l[2] * x[0] - l[4] * x[1] - l[5] * x[2],
+    ]
+}
+
+/// Whether two coordinate vectors are proportional (all 2x2 minors vanish)
+#[inline]
+fn proportional<T: Scalar, const N: usize>(a: &[T; N], b: &[T; N]) -> bool {
+    (0..N).all(|i| ((i + 1)..N).all(|j| a[i] * b[j] == a[j] * b[i]))
+}
+
+/// Whether `line_apply(l, x)` vanishes, row by row through `Scalar::dot_is_zero`
+#[inline]
+fn line_apply_is_zero<T: Scalar>(l: &[T; 6], x: &[T; 4]) -> bool {
+    T::dot_is_zero(&[l[0], l[1], l[2]], &[x[1], x[2], x[3]])
+        && T::dot_is_zero(&[-l[0], l[3], l[4]], &[x[0], x[2], x[3]])
+        && T::dot_is_zero(&[-l[1], -l[3], l[5]], &[x[0], x[1], x[3]])
+        && T::dot_is_zero(&[-l[2], -l[4], -l[5]], &[x[0], x[1], x[2]])
+}
+
+/// `Hash` of the canonical form and `Normalize`, as `impl_coord_object`
+/// provides them for the planar objects
+macro_rules! impl_space_normalize {
+    ($obj:ident) => {
+        impl<T: Scalar + Integer + Hash> Hash for $obj<T> {
+            /// Hashes the canonical form (see `normalize_coord`), so that
+            /// projectively equal objects hash alike
+            #[inline]
+            fn hash<H: Hasher>(&self, state: &mut H) {
+                let mut coord = self.coord;
+                canonical_coord(&mut coord);
+                coord.hash(state);
+            }
+        }
+
+        impl<T: Scalar + Integer + PrimInt + Signed> Normalize for $obj<T> {
+            #[inline]
+            fn normalize(&mut self) {
+                normalize_coord(&mut self.coord);
+            }
+
+            #[inline]
+            fn magnitude_bits(&self) -> u32 {
+                magnitude_bits(&self.coord)
+            }
+        }
+    };
+}
+
+/// Line in Plucker coordinates
+#[derive(Debug, Clone, Copy)]
+pub struct SpaceLineT<T> {
+    /// Plucker coordinate `(01, 02, 03, 12, 13, 23)`
+    pub coord: [T; 6],
+}
+
+impl<T> SpaceLineT<T> {
+    #[inline]
+    pub const fn new(coord: [T; 6]) -> Self {
+        Self { coord }
+    }
+}
+
+impl<T> AsRef<[T; 6]> for SpaceLineT<T> {
+    #[inline]
+    fn as_ref(&self) -> &[T; 6] {
+        &self.coord
+    }
+}
+
+impl<T: Scalar> PartialEq for SpaceLineT<T> {
+    #[inline]
+    fn eq(&self, other: &Self) -> bool {
+        proportional(&self.coord, &other.coord)
+    }
+}
+impl<T: Scalar> Eq for SpaceLineT<T> {}
+
+impl_space_normalize!(SpaceLineT);
+
+impl<T: Scalar> SpaceLineT<T> {
+    /**
+    Whether two lines meet (are coplanar): their reciprocal product vanishes
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::pg_space::{PgSpacePoint, ProjSpacePrim};
+    let o = PgSpacePoint::new([0, 0, 0, 1]);
+    let l1 = o.circ(&PgSpacePoint::new([1, 0, 0, 1]));
+    let l2 = o.circ(&PgSpacePoint::new([0, 1, 0, 1]));
+    let l3 = PgSpacePoint::new([0, 0, 1, 1]).circ(&PgSpacePoint::new([1, 1, 1, 1]));
+    assert!(l1.meets(&l2));
+    assert!(!l1.meets(&l3));
+    ```
+    */
+    #[inline]
+    pub fn meets(&self, other: &Self) -> bool {
+        let (l, m) = (&self.coord, &dual_line(&other.coord));
+        T::dot_n_is_zero(l, m)
+    }
+
+    /// Whether the coordinates satisfy the Plucker relation
+    #[inline]
+    pub fn is_valid(&self) -> bool {
+        let l = &self.coord;
+        T::dot_is_zero(&[l[0], -l[1], l[2]], &[l[5], l[4], l[3]])
+    }
+}
+
+macro_rules! define_space_object {
+    (impl $point:ident) => {
+        #[derive(Debug, Clone, Copy)]
+        pub struct $point<T> {
+            /// Homogeneous coordinate
+            pub coord: [T; 4],
+        }
+
+        impl<T> $point<T> {
+            #[inline]
+            pub const fn new(coord: [T; 4]) -> Self {
+                Self { coord }
+            }
+        }
+
+        impl<T> AsRef<[T; 4]> for $point<T> {
+            #[inline]
+            fn as_ref(&self) -> &[T; 4] {
+                &self.coord
+            }
+        }
+
+        impl<T> From<[T; 4]> for $point<T> {
+            #[inline]
+            fn from(coord: [T; 4]) -> Self {
+                Self::new(coord)
+            }
+        }
+
+        impl<T: Scalar> PartialEq for $point<T> {
+            /// Projective equality: all 2x2 minors vanish
+            #[inline]
+            fn eq(&self, other: &$point<T>) -> bool {
+                proportional(&self.coord, &other.coord)
+            }
+        }
+        impl<T: Scalar> Eq for $point<T> {}
+
+        impl_space_normalize!($point);
+    };
+}
+
+macro_rules! define_space_dual {
+    (impl $point:ident, $plane:ident, $circ:ident, $circ_line:ident, $on_line:ident) => {
+        impl<T: Scalar> ProjSpacePrim<$plane<T>, SpaceLineT<T>> for $point<T> {
+            #[inline]
+            fn incident(&self, dual: &$plane<T>) -> bool {
+                metrics::count(Op::Incident);
+                T::dot_n_is_zero(&self.coord, &dual.coord)
+            }
+
+            #[inline]
+            fn circ(&self, rhs: &Self) -> SpaceLineT<T> {
+                let res = $circ(&self.coord, &rhs.coord);
+                metrics::count(Op::Circ);
+                metrics::record(&res);
+                SpaceLineT::new(res)
+            }
+
+            #[inline]
+            fn circ_line(&self, line: &SpaceLineT<T>) -> $plane<T> {
+                let res = $circ_line(&line.coord, &self.coord);
+                metrics::count(Op::Circ);
+                metrics::record(&res);
+                $plane::new(res)
+            }
+
+            #[inline]
+            fn on_line(&self, line: &SpaceLineT<T>) -> bool {
+                metrics::count(Op::Incident);
+                $on_line(&line.coord, &self.coord)
+            }
+        }
+
+        impl<T: Scalar> ProjSpace<$plane<T>, SpaceLineT<T>, T> for $point<T> {
+            #[inline]
+            fn aux(&self) -> $plane<T> {
+                $plane::new(self.coord)
+            }
+
+            #[inline]
+            fn dot(&self, dual: &$plane<T>) -> T {
+                metrics::count(Op::Dot);
+                dot4(&self.coord, &dual.coord)
+            }
+
+            #[inline]
+            fn plucker(&self, ld: &T, q: &Self, mu: &T) -> Self {
+                let (p, q) = (&self.coord, &q.coord);
+                let res = [0, 1, 2, 3].map(|i| *ld * p[i] + *mu * q[i]);
+                metrics::count(Op::Plucker);
+                metrics::record(&res);
+                Self::new(res)
+            }
+        }
+    };
+}
+
+/// Join of two points
+#[inline]
+fn join<T: Scalar>(p: &[T; 4], q: &[T; 4]) -> [T; 6] {
+    wedge(p, q)
+}
+
+/// Meet of two planes, in primal coordinates
+#[inline]
+fn meet<T: Scalar>(a: &[T; 4], b: &[T; 4]) -> [T; 6] {
+    dual_line(&wedge(a, b))
+}
+
+/// Plane through a line and a point
+#[inline]
+fn span_plane<T: Scalar>(l: &[T; 6], x: &[T; 4]) -> [T; 4] {
+    line_apply(&dual_line(l), x)
+}
+
+/// Whether `span_plane(l, x)` vanishes, i.e. `x` lies on `l`
+#[inline]
+fn span_plane_is_zero<T: Scalar>(l: &[T; 6], x: &[T; 4]) -> bool {
+    line_apply_is_zero(&dual_line(l), x)
+}
+
+macro_rules! define_space_point_and_plane {
+    (impl $point:ident, $plane:ident) => {
+        define_space_object!(impl $point);
+        define_space_object!(impl $plane);
+        define_space_dual!(impl $point, $plane, join, span_plane, span_plane_is_zero);
+        define_space_dual!(impl $plane, $point, meet, line_apply, line_apply_is_zero);
+    };
+}
+
+define_space_point_and_plane!(impl PgSpacePointT, PgSpacePlaneT);
+define_space_point_and_plane!(impl EllSpacePointT, EllSpacePlaneT);
+define_space_point_and_plane!(impl HypSpacePointT, HypSpacePlaneT);
+
+pub type SpaceLine = SpaceLineT<i128>;
+pub type PgSpacePoint = PgSpacePointT<i128>;
+pub type PgSpacePlane = PgSpacePlaneT<i128>;
+pub type EllSpacePoint = EllSpacePointT<i128>;
+pub type EllSpacePlane = EllSpacePlaneT<i128>;
+pub type HypSpacePoint = HypSpacePointT<i128>;
+pub type HypSpacePlane = HypSpacePlaneT<i128>;
+
+macro_rules! define_space_polarity {
+    (impl $point:ident, $plane:ident, $sign:expr) => {
+        impl<T: Scalar> CKSpacePrim<$plane<T>, SpaceLineT<T>> for $point<T> {
+            #[inline]
+            fn perp(&self) -> $plane<T> {
+                let c = &self.coord;
+                $plane::new([c[0], c[1], c[2], $sign(c[3])])
+            }
+        }
+
+        impl<T: Scalar> CKSpacePrim<$point<T>, SpaceLineT<T>> for $plane<T> {
+            #[inline]
+            fn perp(&self) -> $point<T> {
+                let c = &self.coord;
+                $point::new([c[0], c[1], c[2], $sign(c[3])])
+            }
+        }
+
+        impl<T: Scalar> CKSpace<$plane<T>, SpaceLineT<T>, T> for $point<T> {}
+        impl<T: Scalar> CKSpace<$point<T>, SpaceLineT<T>, T> for $plane<T> {}
+    };
+}
+
+// absolute x^2 + y^2 + z^2 + w^2 = 0
+define_space_polarity!(impl EllSpacePointT, EllSpacePlaneT, |w: T| w);
+// absolute x^2 + y^2 + z^2 - w^2 = 0
+define_space_polarity!(impl HypSpacePointT, HypSpacePlaneT, |w: T| -w);
+
+/// Whether `p`, `q` and `r` lie on a common line
+#[inline]
+pub fn collinear<P, H, L>(p: &P, q: &P, r: &P) -> bool
+where
+    P: ProjSpacePrim<H, L>,
+{
+    r.on_line(&p.circ(q))
+}
+
+/// Whether `p`, `q`, `r` and `s` lie on a common plane (`p`, `q`, `r` not collinear)
+#[inline]
+pub fn coplanar<P, H, L>(p: &P, q: &P, r: &P, s: &P) -> bool
+where
+    P: ProjSpacePrim<H, L>,
+{
+    s.incident(&r.circ_line(&p.circ(q)))
+}
+
+/**
+The faces of a tetrahedron, `faces[i]` opposite to `tet[i]`
+
+Examples:
+
+```rust
+use projgeom_rs::pg_space::{tet_dual, PgSpacePlane, PgSpacePoint, ProjSpacePrim};
+let tet = [[0, 0, 0, 1], [1, 0, 0, 1], [0, 1, 0, 1], [0, 0, 1, 1]].map(PgSpacePoint::new);
+let faces: [PgSpacePlane; 4] = tet_dual(&tet);
+assert!(faces[0].incident(&tet[1]) && !faces[0].incident(&tet[0]));
+```
+*/
+#[inline]
+pub fn tet_dual<P, H, L>(tet: &[P; 4]) -> [H; 4]
+where
+    P: ProjSpacePrim<H, L>,
+    H: ProjSpacePrim<P, L>,
+{
+    try_tet_dual(tet).expect("tet_dual: degenerate tetrahedron")
+}
+
+/// Faces of a tetrahedron, or `None` if its vertices are coplanar
+#[inline]
+pub fn try_tet_dual<P, H, L>(tet: &[P; 4]) -> Option<[H; 4]>
+where
+    P: ProjSpacePrim<H, L>,
+    H: ProjSpacePrim<P, L>,
+{
+    let [a0, a1, a2, a3] = tet;
+    let (l01, l23) = (a0.circ(a1), a2.circ(a3));
+    let f3 = a2.circ_line(&l01);
+    if f3.incident(a3) {
+        return None; // coplanar(a0, a1, a2, a3)
+    }
+    Some([
+        a1.circ_line(&l23),
+        a0.circ_line(&l23),
+        a3.circ_line(&l01),
+        f3,
+    ])
+}
+
+/// Harmonic homology with center `origin` and mirror plane `mirror`
+#[inline]
+pub fn involution<P, H, L, V>(origin: &P, mirror: &H, p: &P) -> P
+where
+    V: Scalar,
+    P: ProjSpace<H, L, V>,
+{
+    let om = origin.dot(mirror);
+    let pm = p.dot(mirror);
+    p.plucker(&om, origin, &-(pm + pm))
+}
+
+/**
+Reflection of `p` in the plane `mirror`
+
+Examples:
+
+```rust
+use projgeom_rs::pg_space::{reflect, EllSpacePlane, EllSpacePoint};
+let mirror = EllSpacePlane::new([0, 0, 1, 0]);
+let p = EllSpacePoint::new([1, 2, 3, 4]);
+assert_eq!(reflect(&mirror, &p), EllSpacePoint::new([1, 2, -3, 4]));
+```
+*/
+#[inline]
+pub fn reflect<P, H, L, V>(mirror: &H, p: &P) -> P
+where
+    V: Scalar,
+    P: CKSpace<H, L, V>,
+    H: CKSpace<P, L, V>,
+{
+    involution(&mirror.perp(), mirror, p)
+}
+
+/**
+Element-wise 4-d dot product of two column batches
+
+Examples:
+
+```rust
+use projgeom_rs::pg_space::dot4_many;
+let mut out = vec![0; 2];
+dot4_many([&[1, 0], &[2, 1], &[3, 0], &[4, 1]], [&[4, 7], &[3, 0], &[-2, 1], &[1, 0]], &mut out);
+assert_eq!(out, [8, 0]);
+```
+*/
+#[inline]
+pub fn dot4_many<T: Scalar>(a: [&[T]; 4], b: [&[T]; 4], out: &mut [T]) {
+    let n = out.len();
+    let [ax, ay, az, aw] = a.map(|c| &c[..n]);
+    let [bx, by, bz, bw] = b.map(|c| &c[..n]);
+    for i in 0..n {
+        out[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] + aw[i] * bw[i];
+    }
+}
+
+/**
+Element-wise `wedge` of two column batches: the joins of point pairs
+
+Examples:
+
+```rust
+use projgeom_rs::pg_space::wedge_many;
+let mut out = [0; 6].map(|_| vec![0; 1]);
+let [o0, o1, o2, o3, o4, o5] = &mut out;
+wedge_many([&[1], &[0], &[0], &[0]], [&[0], &[1], &[0], &[0]], [o0, o1, o2, o3, o4, o5]);
+assert_eq!(out.map(|c| c[0]), [1, 0, 0, 0, 0, 0]);
+```
+*/
+#[inline]
+pub fn wedge_many<T: Scalar>(a: [&[T]; 4], b: [&[T]; 4], out: [&mut [T]; 6]) {
+    let n = out[0].len();
+    let [a0, a1, a2, a3] = a.map(|c| &c[..n]);
+    let [b0, b1, b2, b3] = b.map(|c| &c[..n]);
+    let [o0, o1, o2, o3, o4, o5] = out.map(|c| &mut c[..n]);
+    for i in 0..n {
+        o0[i] = a0[i] * b1[i] - a1[i] * b0[i];
+        o1[i] = a0[i] * b2[i] - a2[i] * b0[i];
+        o2[i] = a0[i] * b3[i] - a3[i] * b0[i];
+        o3[i] = a1[i] * b2[i] - a2[i] * b1[i];
+        o4[i] = a1[i] * b3[i] - a3[i] * b1[i];
+        o5[i] = a2[i] * b3[i] - a3[i] * b2[i];
+    }
+}
+
+/// Element-wise `meet` of two plane batches: `wedge_many` read through `dual_line`
+#[inline]
+fn dual_wedge_many<T: Scalar>(a: [&[T]; 4], b: [&[T]; 4], out: [&mut [T]; 6]) {
+    let n = out[0].len();
+    let [a0, a1, a2, a3] = a.map(|c| &c[..n]);
+    let [b0, b1, b2, b3] = b.map(|c| &c[..n]);
+    let [o0, o1, o2, o3, o4, o5] = out.map(|c| &mut c[..n]);
+    for i in 0..n {
+        o0[i] = a2[i] * b3[i] - a3[i] * b2[i];
+        o1[i] = a3[i] * b1[i] - a1[i] * b3[i];
+        o2[i] = a1[i] * b2[i] - a2[i] * b1[i];
+        o3[i] = a0[i] * b3[i] - a3[i] * b0[i];
+        o4[i] = a2[i] * b0[i] - a0[i] * b2[i];
+        o5[i] = a0[i] * b1[i] - a1[i] * b0[i];
+    }
+}
+
+/**
+Element-wise `line_apply` of a line batch to a column batch: the points
+where the lines meet the planes
+
+Examples:
+
+```rust
+use projgeom_rs::pg_space::line_apply_many;
+let mut out = [0; 4].map(|_| vec![0; 1]);
+let [o0, o1, o2, o3] = &mut out;
+let l: [&[i64]; 6] = [&[1], &[0], &[0], &[0], &[0], &[0]];
+line_apply_many(l, [&[0], &[1], &[0], &[0]], [o0, o1, o2, o3]);
+assert_eq!(out.map(|c| c[0]), [1, 0, 0, 0]);
+```
+*/
+#[inline]
+pub fn line_apply_many<T: Scalar>(l: [&[T]; 6], x: [&[T]; 4], out: [&mut [T]; 4]) {
+    let n = out[0].len();
+    let [l0, l1, l2, l3, l4, l5] = l.map(|c| &c[..n]);
+    let [x0, x1, x2, x3] = x.map(|c| &c[..n]);
+    let [o0, o1, o2, o3] = out.map(|c| &mut c[..n]);
+    for i in 0..n {
+        o0[i] = l0[i] * x1[i] + l1[i] * x2[i] + l2[i] * x3[i];
+        o1[i] = -l0[i] * x0[i] + l3[i] * x2[i] + l4[i] * x3[i];
+        o2[i] = -l1[i] * x0[i] - l3[i] * x1[i] + l5[i] * x3[i];
+        o3[i] = -l2[i] * x0[i] - l4[i] * x1[i] - l5[i] * x2[i];
+    }
+}
+
+/// Element-wise `span_plane`: `line_apply_many` read through `dual_line`
+#[inline]
+fn span_plane_many<T: Scalar>(l: [&[T]; 6], x: [&[T]; 4], out: [&mut [T]; 4]) {
+    let n = out[0].len();
+    let [l0, l1, l2, l3, l4, l5] = l.map(|c| &c[..n]);
+    let [x0, x1, x2, x3] = x.map(|c| &c[..n]);
+    let [o0, o1, o2, o3] = out.map(|c| &mut c[..n]);
+    for i in 0..n {
+        o0[i] = l5[i] * x1[i] - l4[i] * x2[i] + l3[i] * x3[i];
+        o1[i] = -l5[i] * x0[i] + l2[i] * x2[i] - l1[i] * x3[i];
+        o2[i] = l4[i] * x0[i] - l2[i] * x1[i] + l0[i] * x3[i];
+        o3[i] = -l3[i] * x0[i] + l1[i] * x1[i] - l0[i] * x2[i];
+    }
+}
+
+/// Structure-of-arrays batch of lines, one column per Plucker coordinate
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub struct SpaceLineBatchT<T> {
+    pub l01: Vec<T>,
+    pub l02: Vec<T>,
+    pub l03: Vec<T>,
+    pub l12: Vec<T>,
+    pub l13: Vec<T>,
+    pub l23: Vec<T>,
+}
+
+impl<T: Scalar> SpaceLineBatchT<T> {
+    #[inline]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    #[inline]
+    fn zeros(n: usize) -> Self {
+        let col = vec![T::ZERO; n];
+        Self {
+            l01: col.clone(),
+            l02: col.clone(),
+            l03: col.clone(),
+            l12: col.clone(),
+            l13: col.clone(),
+            l23: col,
+        }
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.l01.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.l01.is_empty()
+    }
+
+    #[inline]
+    pub fn push(&mut self, l: &SpaceLineT<T>) {
+        for (col, c) in self.columns_mut_vec().into_iter().zip(l.coord) {
+            col.push(c);
+        }
+    }
+
+    #[inline]
+    pub fn get(&self, i: usize) -> SpaceLineT<T> {
+        SpaceLineT::new(self.columns().map(|col| col[i]))
+    }
+
+    pub fn from_slice(lines: &[SpaceLineT<T>]) -> Self {
+        let mut res = Self::new();
+        for l in lines {
+            res.push(l);
+        }
+        res
+    }
+
+    pub fn to_vec(&self) -> Vec<SpaceLineT<T>> {
+        (0..self.len()).map(|i| self.get(i)).collect()
+    }
+
+    #[inline]
+    fn columns(&self) -> [&[T]; 6] {
+        [
+            &self.l01, &self.l02, &self.l03, &self.l12, &self.l13, &self.l23,
+        ]
+    }
+
+    #[inline]
+    fn columns_mut_vec(&mut self) -> [&mut Vec<T>; 6] {
+        [
+            &mut self.l01,
+            &mut self.l02,
+            &mut self.l03,
+            &mut self.l12,
+            &mut self.l13,
+            &mut self.l23,
+        ]
+    }
+
+    #[inline]
+    fn columns_mut(&mut self) -> [&mut [T]; 6] {
+        self.columns_mut_vec().map(|c| c.as_mut_slice())
+    }
+}
+
+macro_rules! define_space_batch {
+    (impl $batch:ident, $point:ident, $dbatch:ident, $plane:ident, $circ_many:ident, $circ_line_many:ident) => {
+        /// Structure-of-arrays batch of homogeneous coordinates
+        #[derive(Debug, Clone, Default, PartialEq, Eq)]
+        pub struct $batch<T> {
+            pub x: Vec<T>,
+            pub y: Vec<T>,
+            pub z: Vec<T>,
+            pub w: Vec<T>,
+        }
+
+        impl<T: Scalar> $batch<T> {
+            #[inline]
+            pub fn new() -> Self {
+                Self::default()
+            }
+
+            #[inline]
+            pub fn len(&self) -> usize {
+                self.x.len()
+            }
+
+            #[inline]
+            pub fn is_empty(&self) -> bool {
+                self.x.is_empty()
+            }
+
+            #[inline]
+            pub fn push(&mut self, p: &$point<T>) {
+                self.x.push(p.coord[0]);
+                self.y.push(p.coord[1]);
+                self.z.push(p.coord[2]);
+                self.w.push(p.coord[3]);
+            }
+
+            #[inline]
+            pub fn get(&self, i: usize) -> $point<T> {
+                $point::new([self.x[i], self.y[i], self.z[i], self.w[i]])
+            }
+
+            pub fn from_slice(pts: &[$point<T>]) -> Self {
+                let mut res = Self::new();
+                for p in pts {
+                    res.push(p);
+                }
+                res
+            }
+
+            pub fn to_vec(&self) -> Vec<$point<T>> {
+                (0..self.len()).map(|i| self.get(i)).collect()
+            }
+
+            #[inline]
+            fn zeros(n: usize) -> Self {
+                let col = vec![T::ZERO; n];
+                Self {
+                    x: col.clone(),
+                    y: col.clone(),
+                    z: col.clone(),
+                    w: col,
+                }
+            }
+
+            #[inline]
+            fn columns(&self) -> [&[T]; 4] {
+                [&self.x, &self.y, &self.z, &self.w]
+            }
+
+            #[inline]
+            fn columns_mut(&mut self) -> [&mut [T]; 4] {
+                [&mut self.x, &mut self.y, &mut self.z, &mut self.w]
+            }
+
+            /// Element-wise join (or meet): `self[i].circ(&rhs[i])`
+            pub fn circ_many(&self, rhs: &Self) -> SpaceLineBatchT<T> {
+                assert_eq!(self.len(), rhs.len());
+                let mut res = SpaceLineBatchT::zeros(self.len());
+                $circ_many(self.columns(), rhs.columns(), res.columns_mut());
+                res
+            }
+
+            /// Element-wise `self[i].circ_line(&lines[i])`
+            pub fn circ_line_many(&self, lines: &SpaceLineBatchT<T>) -> $dbatch<T> {
+                assert_eq!(self.len(), lines.len());
+                let mut res = $dbatch::zeros(self.len());
+                $circ_line_many(lines.columns(), self.columns(), res.columns_mut());
+                res
+            }
+
+            /// Element-wise basic measurement: `self[i].dot(&duals[i])`
+            pub fn dot_many(&self, duals: &$dbatch<T>) -> Vec<T> {
+                assert_eq!(self.len(), duals.len());
+                let mut res = vec![T::ZERO; self.len()];
+                dot4_many(self.columns(), duals.columns(), &mut res);
+                res
+            }
+
+            /// Incidence of every element with a single dual object
+            pub fn incident_mask_with(&self, dual: &$plane<T>) -> Vec<bool> {
+                (0..self.len())
+                    .map(|i| [self.x[i], self.y[i], self.z[i], self.w[i]])
+                    .map(|c| T::dot_n_is_zero(&c, &dual.coord))
+                    .collect()
+            }
+        }
+    };
+}
+
+macro_rules! define_space_batches {
+    (impl $pbatch:ident, $hbatch:ident, $point:ident, $plane:ident) => {
+        define_space_batch!(
+            impl $pbatch,
+            $point,
+            $hbatch,
+            $plane,
+            wedge_many,
+            span_plane_many
+        );
+        define_space_batch!(
+            impl $hbatch,
+            $plane,
+            $pbatch,
+            $point,
+            dual_wedge_many,
+            line_apply_many
+        );
+    };
+}
+
+define_space_batches!(
+    impl PgSpacePointBatchT,
+    PgSpacePlaneBatchT,
+    PgSpacePointT,
+    PgSpacePlaneT
+);
+define_space_batches!(
+    impl EllSpacePointBatchT,
+    EllSpacePlaneBatchT,
+    EllSpacePointT,
+    EllSpacePlaneT
+);
+define_space_batches!(
+    impl HypSpacePointBatchT,
+    HypSpacePlaneBatchT,
+    HypSpacePointT,
+    HypSpacePlaneT
+);
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_join_meet() {
+        let (p, q) = (
+            PgSpacePoint::new([1, 3, 2, 1]),
+            PgSpacePoint::new([-2, 1, -1, 3]),
+        );
+        let r = PgSpacePoint::new([4, -3, 5, -1]);
+        let l = p.circ(&q);
+        assert!(l.is_valid());
+        assert!(p.on_line(&l) && q.on_line(&l) && !r.on_line(&l));
+        let pqr = r.circ_line(&l);
+        assert!(pqr.incident(&p) && pqr.incident(&q) && pqr.incident(&r));
+        // the same line as the meet of two planes through it
+        let s = PgSpacePoint::new([7, 0, 2, 5]);
+        let pqs = s.circ_line(&l);
+        let m = pqr.circ(&pqs);
+        assert_eq!(m, l);
+        assert!(pqr.on_line(&m) && pqs.on_line(&m));
+        // a line meets a plane in a point
+        let x = PgSpacePlane::new([1, 1, 1, 1]).circ_line(&l);
+        assert!(x.on_line(&l) && x.incident(&PgSpacePlane::new([1, 1, 1, 1])));
+        assert!(collinear(&p, &q, &p.plucker(&3, &q, &-5)));
+        assert!(!collinear(&p, &q, &r));
+        assert!(coplanar(&p, &q, &r, &p.plucker(&2, &r, &7)));
+        assert!(!coplanar(&p, &q, &r, &s));
+        // axioms of the dual side
+        assert!(l.meets(&p.circ(&r)));
+        assert!(!l.meets(&r.circ(&s)));
+    }
+
+    #[test]
+    fn test_tet_and_reflect() {
+        let tet =
+            [[1, 3, 2, 1], [-2, 1, -1, 3], [4, -3, 5, -1], [7, 0, 2, 5]].map(HypSpacePoint::new);
+        let faces: [HypSpacePlane; 4] = tet_dual(&tet);
+        for i in 0..4 {
+            for j in 0..4 {
+                assert_eq!(faces[i].incident(&tet[j]), i != j);
+            }
+        }
+        let flat = [tet[0], tet[1], tet[2], tet[0].plucker(&2, &tet[2], &7)];
+        assert!(try_tet_dual::<_, HypSpacePlane, _>(&flat).is_none());
+
+        let mirror = HypSpacePlane::new([3, -1, 7, 2]);
+        for p in tet {
+            let r = reflect(&mirror, &p);
+            assert_eq!(reflect(&mirror, &r), p);
+            // the mirror plane bisects p and its image: the joining line
+            // passes through the pole of the mirror
+            assert!(mirror.perp().on_line(&p.circ(&r)) || r == p);
+        }
+        let on = HypSpacePoint::new([1, 3, 0, 0]);
+        assert!(on.incident(&mirror));
+        assert_eq!(reflect(&mirror, &on), on);
+    }
+
+    #[test]
+    fn test_space_batch() {
+        let pts = [[1, 3, 2, 1], [-2, 1, -1, 3], [1, 3, 0, 0]].map(PgSpacePoint::new);
+        let plane = PgSpacePlane::new([3, -1, 7, 2]);
+        let batch = PgSpacePointBatchT::from_slice(&pts);
+        assert_eq!(batch.to_vec(), pts);
+        assert_eq!(
+            batch.incident_mask_with(&plane),
+            pts.map(|p| p.incident(&plane))
+        );
+        let planes = PgSpacePlaneBatchT::from_slice(&[plane; 3]);
+        assert_eq!(batch.dot_many(&planes), pts.map(|p| p.dot(&plane)));
+
+        // column-wise joins and meets agree with the scalar constructions,
+        // coordinate for coordinate
+        let qs = [[4, -3, 5, -1], [7, 0, 2, 5], [2, 2, -1, 3]].map(PgSpacePoint::new);
+        let qbatch = PgSpacePointBatchT::from_slice(&qs);
+        let lines = batch.circ_many(&qbatch);
+        for i in 0..3 {
+            assert_eq!(lines.get(i).coord, pts[i].circ(&qs[i]).coord);
+        }
+        let spans = qbatch.circ_line_many(&SpaceLineBatchT::from_slice(&[lines.get(1); 3]));
+        for i in 0..3 {
+            assert_eq!(spans.get(i).coord, qs[i].circ_line(&lines.get(1)).coord);
+        }
+        let hs = [[1, 0, 2, -3], [0, 5, 1, 1], [3, 3, -7, 2]].map(PgSpacePlane::new);
+        let hbatch = PgSpacePlaneBatchT::from_slice(&hs);
+        let meets = planes.circ_many(&hbatch);
+        for i in 0..3 {
+            assert_eq!(meets.get(i).coord, plane.circ(&hs[i]).coord);
+        }
+        let xs = hbatch.circ_line_many(&lines);
+        for i in 0..3 {
+            assert_eq!(xs.get(i).coord, hs[i].circ_line(&lines.get(i)).coord);
+        }
+    }
+
+    #[test]
+    fn test_space_robust() {
+        // every rounded sum below vanishes although the exact one does not
+        let p = PgSpacePointT::new([1e16, 1.0, 1.0, 1.0]);
+        let h = PgSpacePlaneT::new([1.0, 1.0, -1e16, 0.0]);
+        assert_eq!(dot4(&p.coord, &h.coord), 0.0);
+        assert!(!p.incident(&h));
+        assert!(p.incident(&PgSpacePlaneT::new([1.0, 1.0, -1e16, -1.0])));
+        let batch = PgSpacePointBatchT::from_slice(&[p; 2]);
+        assert_eq!(batch.incident_mask_with(&h), [false; 2]);
+
+        let l = SpaceLineT::new([1e16, 1.0, -1e16, 0.0, 0.0, 0.0]);
+        let m = SpaceLineT::new([0.0, 0.0, 0.0, 1.0, -1.0, 1.0]);
+        assert!(l.is_valid() && m.is_valid());
+        assert!(!l.meets(&m));
+        assert!(!SpaceLineT::new([1e16, 1.0, 1.0, 1.0, -1e16, 0.0]).is_valid());
+
+        // exactly representable joins and meets stay incident
+        let (a, b) = (
+            PgSpacePointT::new([0.5, -2.0, 3.25, 1.0]),
+            PgSpacePointT::new([1.0, 0.25, -1.0, 2.0]),
+        );
+        assert!(a.on_line(&a.circ(&b)) && b.on_line(&a.circ(&b)));
+        let (g, k) = (
+            PgSpacePlaneT::new([2.0, 0.0, 1.0, 3.0]),
+            PgSpacePlaneT::new([-1.5, 4.0, 0.5, 1.0]),
+        );
+        assert!(g.on_line(&g.circ(&k)) && k.on_line(&g.circ(&k)));
+    }
+
+    #[test]
+    fn test_space_hash() {
+        use crate::reduced::Reduced;
+        use std::collections::HashSet;
+        let p = PgSpacePoint::new([-4, 6, 10, 2]);
+        let mut q = PgSpacePoint::new([6, -9, -15, -3]);
+        let set: HashSet<_> = [p, q].into_iter().collect();
+        assert_eq!(set.len(), 1);
+        q.normalize();
+        assert_eq!(q.coord, [2, -3, -5, -1]);
+        assert_eq!(q.magnitude_bits(), 3);
+        let l = p.circ(&PgSpacePoint::new([1, 0, 0, 1]));
+        let mut m = SpaceLineT::new(l.coord.map(|c| -3 * c));
+        let lines: HashSet<_> = [l, m].into_iter().collect();
+        assert_eq!(lines.len(), 1);
+        m.normalize();
+        assert!(m.magnitude_bits() <= l.magnitude_bits());
+
+        // faces of a tetrahedron, reduced as they are constructed
+        let tet =
+            [[2, 6, 4, 2], [-2, 1, -1, 3], [4, -3, 5, -1], [7, 0, 2, 5]].map(HypSpacePoint::new);
+        let faces: [HypSpacePlane; 4] = tet_dual(&tet);
+        let rfaces: [Reduced<HypSpacePlane>; 4] = tet_dual(&tet.map(Reduced::<_>::new));
+        for i in 0..4 {
+            assert_eq!(rfaces[i].0, faces[i]);
+            assert!(rfaces[i].0.magnitude_bits() <= faces[i].magnitude_bits());
+        }
+        let mirror = Reduced::<_>::new(HypSpacePlane::new([3, -1, 7, 2]));
+        let r = reflect(&mirror, &Reduced::new(tet[0]));
+        assert_eq!(r.0, reflect(&mirror.0, &tet[0]));
+    }
+
+    #[cfg(feature = "metrics")]
+    #[test]
+    fn test_space_metrics() {
+        let _guard = metrics::test_guard();
+        let before = metrics::local_snapshot();
+        let (p, q) = (
+            PgSpacePoint::new([1 << 40, 3, 2, 1]),
+            PgSpacePoint::new([-2, 1, -1, 3]),
+        );
+        let l = p.circ(&q);
+        let h = PgSpacePoint::new([4, -3, 5, -1]).circ_line(&l);
+        assert!(h.incident(&p));
+        let d = metrics::local_snapshot();
+        assert_eq!(d.count(Op::Circ) - before.count(Op::Circ), 2);
+        assert_eq!(d.count(Op::Incident) - before.count(Op::Incident), 1);
+        assert!(d.above(40) > before.above(40));
+    }
+}
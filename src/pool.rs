@@ -0,0 +1,372 @@
+// Reusable typed pools for per-frame intermediate objects
+//
+// A `Pool<O>` is an append-only arena addressed by `Handle<O>`: bulk appends
+// return a range of handles, and `reset` forgets the contents but keeps the
+// allocation, so a frame that produces no more objects than an earlier one
+// does not touch the heap. `Frame` pairs a point pool and a line pool of one
+// geometry and runs the constructions straight into them, with handles as
+// the references between points and the lines built from them. Handles are
+// only meaningful until the next `reset` of their pool.
+
+use crate::ck_plane::{altitude, CKPlanePrim};
+use crate::pg_plane::ProjPlanePrim;
+use core::fmt;
+use core::hash::{Hash, Hasher};
+use core::marker::PhantomData;
+use core::ops::{Index, Range};
+
+/// Index of an object in a `Pool<O>`
+pub struct Handle<O> {
+    index: u32,
+    kind: PhantomData<fn() -> O>,
+}
+
+impl<O> Handle<O> {
+    #[inline]
+    const fn new(index: usize) -> Self {
+        Self {
+            index: index as u32,
+            kind: PhantomData,
+        }
+    }
+
+    #[inline]
+    pub const fn index(self) -> usize {
+        self.index as usize
+    }
+}
+
+// not derived: a handle is `Copy` and `Eq` whatever `O` is
+impl<O> Clone for Handle<O> {
+    #[inline]
+    fn clone(&self) -> Self {
+        *self
+    }
+}
+impl<O> Copy for Handle<O> {}
+
+impl<O> PartialEq for Handle<O> {
+    #[inline]
+    fn eq(&self, other: &Self) -> bool {
+        self.index == other.index
+    }
+}
+impl<O> Eq for Handle<O> {}
+
+impl<O> Hash for Handle<O> {
+    #[inline]
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.index.hash(state);
+    }
+}
+
+impl<O> fmt::Debug for Handle<O> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "Handle({})", self.index)
+    }
+}
+
+/// Consecutive handles returned by a bulk append
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct Handles<O> {
+    range: Range<u32>,
+    kind: PhantomData<fn() -> O>,
+}
+
+impl<O> Handles<O> {
+    #[inline]
+    fn new(range: Range<usize>) -> Self {
+        Self {
+            range: range.start as u32..range.end as u32,
+            kind: PhantomData,
+        }
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.range.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.range.is_empty()
+    }
+
+    #[inline]
+    pub fn get(&self, i: usize) -> Handle<O> {
+        assert!(i < self.len());
+        Handle::new(self.range.start as usize + i)
+    }
+
+    #[inline]
+    pub fn iter(&self) -> impl Iterator<Item = Handle<O>> {
+        self.range.clone().map(|i| Handle::new(i as usize))
+    }
+}
+
+#[derive(Debug, Clone)]
+pub struct Pool<O> {
+    items: Vec<O>,
+}
+
+impl<O> Default for Pool<O> {
+    fn default() -> Self {
+        Self { items: Vec::new() }
+    }
+}
+
+impl<O> Pool<O> {
+    #[inline]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    #[inline]
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self {
+            items: Vec::with_capacity(capacity),
+        }
+    }
+
+    #[inline]
+    pub fn len(&self) -> usize {
+        self.items.len()
+    }
+
+    #[inline]
+    pub fn is_empty(&self) -> bool {
+        self.items.is_empty()
+    }
+
+    #[inline]
+    pub fn capacity(&self) -> usize {
+        self.items.capacity()
+    }
+
+    #[inline]
+    pub fn push(&mut self, obj: O) -> Handle<O> {
+        assert!(self.items.len() < u32::MAX as usize);
+        self.items.push(obj);
+        Handle::new(self.items.len() - 1)
+    }
+
+    /**
+    Append every object of `objs`
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::pool::Pool;
+    use projgeom_rs::PgPoint;
+    let mut pool = Pool::new();
+    let hs = pool.extend((0..3).map(|i| PgPoint::new([i, 1, 1])));
+    assert_eq!(pool[hs.get(2)], PgPoint::new([2, 1, 1]));
+    let cap = pool.capacity();
+    pool.reset();
+    pool.extend((0..3).map(|i| PgPoint::new([1, i, 1])));
+    assert_eq!(pool.capacity(), cap);
+    ```
+    */
+    pub fn extend<I: IntoIterator<Item = O>>(&mut self, objs: I) -> Handles<O> {
+        let start = self.items.len();
+        self.items.extend(objs);
+        assert!(self.items.len() <= u32::MAX as usize);
+        Handles::new(start..self.items.len())
+    }
+
+    #[inline]
+    pub fn get(&self, h: Handle<O>) -> Option<&O> {
+        self.items.get(h.index())
+    }
+
+    #[inline]
+    pub fn as_slice(&self) -> &[O] {
+        &self.items
+    }
+
+    /// Objects of a bulk append
+    #[inline]
+    pub fn slice(&self, hs: &Handles<O>) -> &[O] {
+        &self.items[hs.range.start as usize..hs.range.end as usize]
+    }
+
+    /// Drop the contents and keep the allocation
+    #[inline]
+    pub fn reset(&mut self) {
+        self.items.clear();
+    }
+}
+
+impl<O: Clone> Pool<O> {
+    #[inline]
+    pub fn extend_from_slice(&mut self, objs: &[O]) -> Handles<O> {
+        let start = self.items.len();
+        self.items.extend_from_slice(objs);
+        assert!(self.items.len() <= u32::MAX as usize);
+        Handles::new(start..self.items.len())
+    }
+}
+
+impl<O> Index<Handle<O>> for Pool<O> {
+    type Output = O;
+
+    #[inline]
+    fn index(&self, h: Handle<O>) -> &O {
+        &self.items[h.index()]
+    }
+}
+
+/// Point and line pools of one geometry
+#[derive(Debug, Clone)]
+pub struct Frame<P, L> {
+    pub points: Pool<P>,
+    pub lines: Pool<L>,
+}
+
+impl<P, L> Default for Frame<P, L> {
+    fn default() -> Self {
+        Self {
+            points: Pool::new(),
+            lines: Pool::new(),
+        }
+    }
+}
+
+impl<P, L> Frame<P, L>
+where
+    P: ProjPlanePrim<L>,
+    L: ProjPlanePrim<P>,
+{
+    #[inline]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Reset both pools, keeping their allocations
+    #[inline]
+    pub fn reset(&mut self) {
+        self.points.reset();
+        self.lines.reset();
+    }
+
+    #[inline]
+    pub fn join(&mut self, a: Handle<P>, b: Handle<P>) -> Handle<L> {
+        let l = self.points[a].circ(&self.points[b]);
+        self.lines.push(l)
+    }
+
+    #[inline]
+    pub fn meet(&mut self, l: Handle<L>, m: Handle<L>) -> Handle<P> {
+        let p = self.lines[l].circ(&self.lines[m]);
+        self.points.push(p)
+    }
+
+    /**
+    Sides of every triangle of points `tris`, three lines per triangle
+
+    The sides of `tris.get(i)` are `sides.get(3 * i + j)`, in `tri_dual` order.
+    The vertices are not checked for collinearity.
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::pool::Frame;
+    use projgeom_rs::{tri_dual, PgLine, PgPoint};
+    let mut frame = Frame::<PgPoint, PgLine>::new();
+    let coords = [[0, 0, 1], [1, 0, 1], [0, 1, 1]];
+    let tris = frame.points.extend(coords.map(PgPoint::new));
+    let sides = frame.tri_duals(&tris);
+    let expected: [PgLine; 3] = tri_dual(&coords.map(PgPoint::new));
+    assert_eq!(frame.lines.slice(&sides), expected);
+    ```
+    */
+    pub fn tri_duals(&mut self, tris: &Handles<P>) -> Handles<L> {
+        assert_eq!(tris.len() % 3, 0);
+        let pts = self.points.slice(tris);
+        self.lines.extend(pts.chunks_exact(3).flat_map(|t| {
+            let [a1, a2, a3] = [&t[0], &t[1], &t[2]];
+            [a2.circ(a3), a1.circ(a3), a1.circ(a2)]
+        }))
+    }
+
+    /// Meet of every pair `(i, j)`, `i < j`, of the lines `ls`, in
+    /// lexicographic order of the pairs
+    pub fn meet_pairs(&mut self, ls: &Handles<L>) -> Handles<P> {
+        let lines = self.lines.slice(ls);
+        let n = lines.len();
+        self.points
+            .extend((0..n).flat_map(|i| ((i + 1)..n).map(move |j| lines[i].circ(&lines[j]))))
+    }
+}
+
+impl<P, L> Frame<P, L>
+where
+    P: CKPlanePrim<L>,
+    L: CKPlanePrim<P>,
+{
+    /// Altitudes of every triangle of points `tris`, as `tri_duals` lays out sides
+    pub fn tri_altitudes(&mut self, tris: &Handles<P>) -> Handles<L> {
+        assert_eq!(tris.len() % 3, 0);
+        let pts = self.points.slice(tris);
+        self.lines.extend(pts.chunks_exact(3).flat_map(|t| {
+            let [a1, a2, a3] = [&t[0], &t[1], &t[2]];
+            [
+                altitude(a1, &a2.circ(a3)),
+                altitude(a2, &a1.circ(a3)),
+                altitude(a3, &a1.circ(a2)),
+            ]
+        }))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ck_plane::tri_altitude;
+    use crate::pg_object::{EuclidLine, EuclidPoint};
+
+    fn coords(frame: usize) -> Vec<[i128; 3]> {
+        (0..30)
+            .map(|i| {
+                let x = (i + frame) as i128;
+                [x, x * x % 17, 1]
+            })
+            .collect()
+    }
+
+    #[test]
+    fn test_frames_reuse_storage() {
+        let mut frame = Frame::<EuclidPoint, EuclidLine>::new();
+        let mut caps = None;
+        for f in 0..4 {
+            frame.reset();
+            let tris = frame
+                .points
+                .extend(coords(f).into_iter().map(EuclidPoint::new));
+            let alts = frame.tri_altitudes(&tris);
+            for (i, t) in frame.points.slice(&tris).chunks_exact(3).enumerate() {
+                let expected: [EuclidLine; 3] = tri_altitude(&[t[0], t[1], t[2]]);
+                for (j, e) in expected.iter().enumerate() {
+                    assert_eq!(frame.lines[alts.get(3 * i + j)], *e);
+                }
+            }
+            // pairwise meets of the altitudes of the first triangle
+            let sides = frame.tri_duals(&tris);
+            let first = Handles::new(alts.get(0).index()..alts.get(2).index() + 1);
+            let os = frame.meet_pairs(&first);
+            assert_eq!(os.len(), 3);
+            assert!(os
+                .iter()
+                .all(|o| frame.points[o] == frame.points[os.get(0)]));
+            let l = frame.join(tris.get(0), tris.get(1));
+            assert_eq!(frame.lines[l], frame.lines[sides.get(2)]);
+
+            let now = (frame.points.capacity(), frame.lines.capacity());
+            if f > 0 {
+                // same size of frame: no reallocation
+                assert_eq!(Some(now), caps);
+            }
+            caps = Some(now);
+        }
+    }
+}
@@ -0,0 +1,220 @@
+// Opt-in projective normalization
+//
+// `Reduced<P, BITS>` wraps a point or line (or a point, plane or line of
+// `pg_space`) and normalizes every object it constructs (`circ`,
+// `circ_line`, `aux`, `plucker`, `perp`) with `Normalize`. With the
+// default `BITS = 0` the reduction is eager; otherwise it only happens once
+// a coordinate grows beyond `BITS` bits, which keeps long construction
+// chains (`harm_conj`, `involution`, `orthocenter`, ...) bounded while
+// skipping the gcd for small values.
+
+use crate::ck_plane::{CKPlane, CKPlanePrim};
+use crate::pg_object::Normalize;
+use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+use crate::pg_space::{CKSpace, CKSpacePrim, ProjSpace, ProjSpacePrim};
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct Reduced<P, const BITS: u32 = 0>(pub P);
+
+impl<P: Normalize, const BITS: u32> Reduced<P, BITS> {
+    /**
+    Wrap and reduce
+
+    Examples:
+
+    ```rust
+    use projgeom_rs::{PgPoint, Reduced};
+    let p = Reduced::<_>::new(PgPoint::new([-4, 6, 10]));
+    assert_eq!(p.0.coord, [2, -3, -5]);
+    ```
+    */
+    #[inline]
+    pub fn new(obj: P) -> Self {
+        let mut res = Self(obj);
+        res.reduce();
+        res
+    }
+
+    #[inline]
+    fn reduce(&mut self) {
+        if self.0.magnitude_bits() > BITS {
+            self.0.normalize();
+        }
+    }
+
+    #[inline]
+    pub fn into_inner(self) -> P {
+        self.0
+    }
+}
+
+impl<P, L, const BITS: u32> ProjPlanePrim<Reduced<L, BITS>> for Reduced<P, BITS>
+where
+    P: ProjPlanePrim<L>,
+    L: Normalize,
+{
+    #[inline]
+    fn circ(&self, rhs: &Self) -> Reduced<L, BITS> {
+        Reduced::new(self.0.circ(&rhs.0))
+    }
+
+    #[inline]
+    fn incident(&self, line: &Reduced<L, BITS>) -> bool {
+        self.0.incident(&line.0)
+    }
+}
+
+impl<P, L, V, const BITS: u32> ProjPlane<Reduced<L, BITS>, V> for Reduced<P, BITS>
+where
+    V: Default + PartialEq,
+    P: ProjPlane<L, V> + Normalize,
+    L: Normalize,
+{
+    #[inline]
+    fn aux(&self) -> Reduced<L, BITS> {
+        Reduced::new(self.0.aux())
+    }
+
+    #[inline]
+    fn dot(&self, line: &Reduced<L, BITS>) -> V {
+        self.0.dot(&line.0)
+    }
+
+    #[inline]
+    fn plucker(&self, ld: &V, q: &Self, mu: &V) -> Self {
+        Reduced::new(self.0.plucker(ld, &q.0, mu))
+    }
+}
+
+impl<P, L, const BITS: u32> CKPlanePrim<Reduced<L, BITS>> for Reduced<P, BITS>
+where
+    P: CKPlanePrim<L>,
+    L: Normalize,
+{
+    #[inline]
+    fn perp(&self) -> Reduced<L, BITS> {
+        Reduced::new(self.0.perp())
+    }
+}
+
+impl<P, L, V, const BITS: u32> CKPlane<Reduced<L, BITS>, V> for Reduced<P, BITS>
+where
+    V: Default + PartialEq,
+    P: CKPlane<L, V> + Normalize,
+    L: Normalize,
+{
+}
+
+impl<P, H, L, const BITS: u32> ProjSpacePrim<Reduced<H, BITS>, Reduced<L, BITS>>
+    for Reduced<P, BITS>
+where
+    P: ProjSpacePrim<H, L>,
+    H: Normalize,
+    L: Normalize,
+{
+    #[inline]
+    fn incident(&self, dual: &Reduced<H, BITS>) -> bool {
+        self.0.incident(&dual.0)
+    }
+
+    #[inline]
+    fn circ(&self, rhs: &Self) -> Reduced<L, BITS> {
+        Reduced::new(self.0.circ(&rhs.0))
+    }
+
+    #[inline]
+    fn circ_line(&self, line: &Reduced<L, BITS>) -> Reduced<H, BITS> {
+        Reduced::new(self.0.circ_line(&line.0))
+    }
+
+    #[inline]
+    fn on_line(&self, line: &Reduced<L, BITS>) -> bool {
+        self.0.on_line(&line.0)
+    }
+}
+
+impl<P, H, L, V, const BITS: u32> ProjSpace<Reduced<H, BITS>, Reduced<L, BITS>, V>
+    for Reduced<P, BITS>
+where
+    V: Default + PartialEq,
+    P: ProjSpace<H, L, V> + Normalize,
+    H: Normalize,
+    L: Normalize,
+{
+    #[inline]
+    fn aux(&self) -> Reduced<H, BITS> {
+        Reduced::new(self.0.aux())
+    }
+
+    #[inline]
+    fn dot(&self, dual: &Reduced<H, BITS>) -> V {
+        self.0.dot(&dual.0)
+    }
+
+    #[inline]
+    fn plucker(&self, ld: &V, q: &Self, mu: &V) -> Self {
+        Reduced::new(self.0.plucker(ld, &q.0, mu))
+    }
+}
+
+impl<P, H, L, const BITS: u32> CKSpacePrim<Reduced<H, BITS>, Reduced<L, BITS>> for Reduced<P, BITS>
+where
+    P: CKSpacePrim<H, L>,
+    H: Normalize,
+    L: Normalize,
+{
+    #[inline]
+    fn perp(&self) -> Reduced<H, BITS> {
+        Reduced::new(self.0.perp())
+    }
+}
+
+impl<P, H, L, V, const BITS: u32> CKSpace<Reduced<H, BITS>, Reduced<L, BITS>, V>
+    for Reduced<P, BITS>
+where
+    V: Default + PartialEq,
+    P: CKSpace<H, L, V> + Normalize,
+    H: Normalize,
+    L: Normalize,
+{
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::ck_plane::{orthocenter, reflect};
+    use crate::pg_object::{HypLine, HypPoint, Normalize};
+    use crate::pg_plane::involution;
+
+    #[test]
+    fn test_reduced_chain() {
+        let a1 = HypPoint::new([13, 23, 32]);
+        let a2 = HypPoint::new([44, -34, 2]);
+        let a3 = HypPoint::new([-2, 12, 23]);
+        let o = orthocenter(&[a1, a2, a3]);
+        let r = orthocenter(&[Reduced::<_>::new(a1), Reduced::new(a2), Reduced::new(a3)]);
+        assert_eq!(r.0, o);
+        assert!(r.0.magnitude_bits() <= o.magnitude_bits());
+
+        let mirror = HypLine::new([3, -1, 7]);
+        let origin = HypPoint::new([1, 1, 5]);
+        let p = HypPoint::new([2, 5, 3]);
+        let p1 = reflect(&mirror, &involution(&origin, &mirror, &p));
+        let p2 = reflect(&mirror, &involution(&origin, &mirror, &p1));
+        assert!(p2.magnitude_bits() > 64);
+
+        let (rm, ro) = (Reduced::<_>::new(mirror), Reduced::new(origin));
+        let (lm, lo) = (Reduced::<_, 32>::new(mirror), Reduced::new(origin));
+        let mut q = Reduced::new(p);
+        let mut lazy = Reduced::new(p);
+        for i in 0..6 {
+            q = reflect(&rm, &involution(&ro, &rm, &q));
+            lazy = reflect(&lm, &involution(&lo, &lm, &lazy));
+            if i == 0 {
+                assert_eq!(q.0, p1);
+            }
+            assert_eq!(q.0, lazy.0);
+            assert!(q.0.magnitude_bits() <= 16);
+        }
+    }
+}
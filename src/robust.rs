@@ -0,0 +1,285 @@
+// Robust sign tests for f64 coordinates
+//
+// The predicates are first evaluated in plain floating point together with
+// a forward error bound; only when the result is too close to zero to be
+// trusted are they recomputed exactly with error-free transformations
+// (`two_product` via FMA, `two_sum`), in the style of Shewchuk's adaptive
+// predicates. The answer is the sign of the exact real value, as long as
+// no intermediate product overflows or underflows.
+
+use core::cmp::Ordering;
+
+const U: f64 = f64::EPSILON / 2.0;
+/// Bound on the relative error of a three-term float dot product
+const DOT_BOUND: f64 = (4.0 + 32.0 * U) * U;
+/// Bound on the relative error of a float `a . (b x c)`
+const DET_BOUND: f64 = (8.0 + 64.0 * U) * U;
+
+#[inline]
+fn two_sum(a: f64, b: f64) -> (f64, f64) {
+    let x = a + b;
+    let bv = x - a;
+    let av = x - bv;
+    (x, (a - av) + (b - bv))
+}
+
+#[inline]
+fn two_product(a: f64, b: f64) -> (f64, f64) {
+    let x = a * b;
+    (x, a.mul_add(b, -x))
+}
+
+#[inline]
+fn sign(x: f64) -> Ordering {
+    x.partial_cmp(&0.0).unwrap_or(Ordering::Equal)
+}
+
+/// Sign of the exact sum of `terms` (Shewchuk's grow-expansion)
+fn exact_sum_sign(terms: &[f64]) -> Ordering {
+    let mut expansion = [0.0; 24];
+    let mut len = 0;
+    for t in terms {
+        let mut q = *t;
+        let mut out = 0;
+        for i in 0..len {
+            let (s, e) = two_sum(q, expansion[i]);
+            q = s;
+            if e != 0.0 {
+                expansion[out] = e;
+                out += 1;
+            }
+        }
+        expansion[out] = q;
+        len = out + 1;
+    }
+    // components are non-overlapping and increasing in magnitude
+    expansion[..len]
+        .iter()
+        .rev()
+        .map(|c| sign(*c))
+        .find(|s| *s != Ordering::Equal)
+        .unwrap_or(Ordering::Equal)
+}
+
+/**
+Exact sign of `a . b`
+
+Examples:
+
+```rust
+use core::cmp::Ordering;
+use projgeom_rs::robust::dot_sign;
+let (a, b) = ([1e16, 1.0, -1e16], [1.0, 1.0, 1.0]);
+assert_eq!(1e16 + 1.0 - 1e16, 0.0);
+assert_eq!(dot_sign(&a, &b), Ordering::Greater);
+assert_eq!(dot_sign(&[0.5, 2.0, 1.0], &[4.0, -1.0, 0.0]), Ordering::Equal);
+```
+*/
+#[inline]
+pub fn dot_sign(a: &[f64; 3], b: &[f64; 3]) -> Ordering {
+    let p = [a[0] * b[0], a[1] * b[1], a[2] * b[2]];
+    let d = p[0] + p[1] + p[2];
+    let m = p[0].abs() + p[1].abs() + p[2].abs();
+    if d.abs() > DOT_BOUND * m {
+        return sign(d);
+    }
+    dot_sign_exact(a, b)
+}
+
+#[cold]
+fn dot_sign_exact(a: &[f64; 3], b: &[f64; 3]) -> Ordering {
+    let mut terms = [0.0; 6];
+    for i in 0..3 {
+        let (x, e) = two_product(a[i], b[i]);
+        terms[2 * i] = e;
+        terms[2 * i + 1] = x;
+    }
+    exact_sum_sign(&terms)
+}
+
+/**
+Exact sign of the `N`-term dot product `a . b`, for `N <= 12`
+
+The space predicates (4-term incidence, the 6-term Plucker products) go
+through this; `dot_sign` is its three-term case with a tighter bound.
+
+Examples:
+
+```rust
+use core::cmp::Ordering;
+use projgeom_rs::robust::dot_sign_n;
+let (a, b) = ([1e16, 1.0, -1e16, 1.0], [1.0, 1.0, 1.0, -1.0]);
+assert_eq!(dot_sign_n(&a, &b), Ordering::Equal);
+assert_eq!(dot_sign_n(&a, &[1.0, 1.0, 1.0, 0.0]), Ordering::Greater);
+```
+*/
+#[inline]
+pub fn dot_sign_n<const N: usize>(a: &[f64; N], b: &[f64; N]) -> Ordering {
+    assert!(N <= 12);
+    let (mut d, mut m) = (0.0, 0.0);
+    for i in 0..N {
+        let p = a[i] * b[i];
+        d += p;
+        m += p.abs();
+    }
+    // N products and N - 1 additions: (N + 1) u covers gamma_N with margin
+    if d.abs() > ((N + 1) as f64 + 32.0 * U) * U * m {
+        return sign(d);
+    }
+    dot_sign_n_exact(a, b)
+}
+
+#[cold]
+fn dot_sign_n_exact<const N: usize>(a: &[f64; N], b: &[f64; N]) -> Ordering {
+    let mut terms = [0.0; 24];
+    for i in 0..N {
+        let (x, e) = two_product(a[i], b[i]);
+        terms[2 * i] = e;
+        terms[2 * i + 1] = x;
+    }
+    exact_sum_sign(&terms[..2 * N])
+}
+
+/**
+Exact sign of the determinant `a . (b x c)`
+
+Zero exactly when the three points (or lines) are coincident.
+
+Examples:
+
+```rust
+use core::cmp::Ordering;
+use projgeom_rs::robust::det_sign;
+let (a, b) = ([0.5, 0.25, 1.0], [1.5, 0.75, 1.0]);
+assert_eq!(det_sign(&a, &b, &[2.5, 1.25, 1.0]), Ordering::Equal);
+let nudged = f64::from_bits(1.25f64.to_bits() + 1);
+assert_eq!(det_sign(&a, &b, &[2.5, nudged, 1.0]), Ordering::Greater);
+```
+*/
+#[inline]
+pub fn det_sign(a: &[f64; 3], b: &[f64; 3], c: &[f64; 3]) -> Ordering {
+    let mut d = 0.0;
+    let mut m = 0.0;
+    for i in 0..3 {
+        let (j, k) = ((i + 1) % 3, (i + 2) % 3);
+        let (x, y) = (b[j] * c[k], b[k] * c[j]);
+        d += a[i] * (x - y);
+        m += a[i].abs() * (x.abs() + y.abs());
+    }
+    if d.abs() > DET_BOUND * m {
+        return sign(d);
+    }
+    det_sign_exact(a, b, c)
+}
+
+#[cold]
+fn det_sign_exact(a: &[f64; 3], b: &[f64; 3], c: &[f64; 3]) -> Ordering {
+    let mut terms = [0.0; 24];
+    let mut n = 0;
+    for i in 0..3 {
+        let (j, k) = ((i + 1) % 3, (i + 2) % 3);
+        for (s, t, sgn) in [(b[j], c[k], 1.0), (b[k], c[j], -1.0)] {
+            let (x, e) = two_product(s, t);
+            let (x1, e1) = two_product(sgn * a[i], x);
+            let (x2, e2) = two_product(sgn * a[i], e);
+            terms[n..n + 4].copy_from_slice(&[e2, x2, e1, x1]);
+            n += 4;
+        }
+    }
+    exact_sum_sign(&terms)
+}
+
+/**
+Exact coincidence test for points (or lines) with f64 coordinates
+
+`ProjPlanePrim::incident` on f64 objects is already exact (see
+`Scalar::dot_is_zero`); `pg_plane::coincident` goes through a rounded
+`circ`, which this avoids.
+
+Examples:
+
+```rust
+use projgeom_rs::{robust, EllPointT};
+let p = EllPointT::new([0.5, 0.25, 1.0]);
+let q = EllPointT::new([1.5, 0.75, 1.0]);
+assert!(robust::coincident(&p, &q, &EllPointT::new([2.5, 1.25, 1.0])));
+assert!(!robust::coincident(&p, &q, &EllPointT::new([2.5, 1.25 + 1e-15, 1.0])));
+```
+*/
+#[inline]
+pub fn coincident<P: AsRef<[f64; 3]>>(p: &P, q: &P, r: &P) -> bool {
+    det_sign(p.as_ref(), q.as_ref(), r.as_ref()) == Ordering::Equal
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    struct Rng(u64);
+
+    impl Rng {
+        fn int(&mut self, bits: u32) -> i64 {
+            self.0 ^= self.0 << 13;
+            self.0 ^= self.0 >> 7;
+            self.0 ^= self.0 << 17;
+            (self.0 % (1 << bits)) as i64 - (1 << (bits - 1))
+        }
+    }
+
+    fn float(c: [i64; 3]) -> [f64; 3] {
+        c.map(|x| x as f64)
+    }
+
+    #[test]
+    fn test_robust_incidence() {
+        use crate::ck_plane::is_perpendicular;
+        use crate::pg_object::{HypLineT, HypPointT};
+        use crate::pg_plane::ProjPlanePrim;
+
+        // the rounded dot product vanishes although the point is off the line
+        let p = HypPointT::new([1e16, 1.0, 1.0]);
+        let l = HypLineT::new([1.0, 1.0, -1e16]);
+        assert_eq!(crate::pg_object::dot(&p.coord, &l.coord), 0.0);
+        assert!(!p.incident(&l));
+        assert!(HypPointT::new([1e16, 0.0, 1.0]).incident(&l));
+        // the pole of `l` is [1, 1, 1e16]
+        assert!(!is_perpendicular(&l, &HypLineT::new([1e16, 1.0, -1.0])));
+        assert!(is_perpendicular(&l, &HypLineT::new([1e16, 0.0, -1.0])));
+    }
+
+    #[test]
+    fn test_robust_signs() {
+        // integers below 2^53 are exact in f64 while their products are not
+        let mut rng = Rng(0x2545_f491_4f6c_dd1d);
+        for _ in 0..1000 {
+            let a = [rng.int(50), rng.int(50), (1 << 49) + rng.int(48)];
+            let (b0, b1) = (rng.int(50), rng.int(50));
+            let s = a[0] as i128 * b0 as i128 + a[1] as i128 * b1 as i128;
+            let b = [b0, b1, (-s / a[2] as i128) as i64 + rng.int(2)];
+            let exact = (0..3).map(|i| a[i] as i128 * b[i] as i128).sum::<i128>();
+            assert_eq!(dot_sign(&float(a), &float(b)), exact.cmp(&0));
+
+            let p = [rng.int(30), rng.int(30), rng.int(30)];
+            let q = [rng.int(30), rng.int(30), rng.int(30)];
+            let t = rng.int(8);
+            let r = [0, 1, 2].map(|i| p[i] + t * (q[i] - p[i]) + rng.int(2));
+            let w = |i: usize| [p[i] as i128, q[i] as i128, r[i] as i128];
+            let (x, y, z) = (w(0), w(1), w(2));
+            let det = x[0] * (y[1] * z[2] - y[2] * z[1]) - x[1] * (y[0] * z[2] - y[2] * z[0])
+                + x[2] * (y[0] * z[1] - y[1] * z[0]);
+            assert_eq!(det_sign(&float(p), &float(q), &float(r)), det.cmp(&0));
+
+            // six terms, the last chosen to nearly cancel the rest
+            let mut a = [0; 6].map(|_| rng.int(50));
+            let mut b = [0; 6].map(|_| rng.int(50));
+            a[5] = (1 << 49) + rng.int(48);
+            let s = (0..5).map(|i| a[i] as i128 * b[i] as i128).sum::<i128>();
+            b[5] = (-s / a[5] as i128) as i64 + rng.int(2);
+            let exact = (0..6).map(|i| a[i] as i128 * b[i] as i128).sum::<i128>();
+            assert_eq!(
+                dot_sign_n(&a.map(|x| x as f64), &b.map(|x| x as f64)),
+                exact.cmp(&0)
+            );
+        }
+    }
+}
@@ -0,0 +1,347 @@
+// Streaming theorem verification
+//
+// `verify_stream` runs a check over an unbounded stream of configurations
+// without collecting it. One thread pulls the input and cuts it into chunks
+// of `chunk_len`; worker threads check the chunks; the calling thread
+// receives a `ChunkReport` per finished chunk, with the failures in it and
+// the running totals. Both queues are `mpsc::sync_channel`s of `max_pending`
+// chunks, so a slow consumer stalls the workers and the workers stall the
+// input: at most about `2 * max_pending + workers` chunks are in memory at
+// any time. Chunks may finish out of order; every failure carries its index
+// in the input.
+//
+// `Xorshift` and the `*_configs` generators produce deterministic random
+// inputs for the `pg_plane` theorem checks at a given coordinate width.
+
+use crate::pg_plane::{ProjPlane, ProjPlanePrim};
+use std::sync::mpsc::{sync_channel, Receiver};
+use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct VerifierConfig {
+    /// Configurations per chunk
+    pub chunk_len: usize,
+    /// Capacity of each queue, in chunks
+    pub max_pending: usize,
+    /// Worker threads
+    pub workers: usize,
+}
+
+impl Default for VerifierConfig {
+    fn default() -> Self {
+        Self {
+            chunk_len: 1024,
+            max_pending: 4,
+            workers: std::thread::available_parallelism().map_or(1, |n| n.get()),
+        }
+    }
+}
+
+/// Running totals
+#[derive(Debug, Clone, Copy, Default, PartialEq)]
+pub struct Progress {
+    pub checked: u64,
+    pub failed: u64,
+    pub elapsed: Duration,
+}
+
+impl Progress {
+    /// Configurations checked per second
+    #[inline]
+    pub fn throughput(&self) -> f64 {
+        self.checked as f64 / self.elapsed.as_secs_f64().max(1e-9)
+    }
+}
+
+/// Result of one chunk
+#[derive(Debug, Clone)]
+pub struct ChunkReport<C> {
+    /// Index in the input of the first configuration of the chunk
+    pub start: u64,
+    pub len: usize,
+    /// Failing configurations with their index in the input
+    pub failures: Vec<(u64, C)>,
+    /// Totals including this chunk
+    pub progress: Progress,
+}
+
+type Chunk<C> = (u64, Vec<C>);
+/// Start, length and failures of a checked chunk
+type Checked<C> = (u64, usize, Vec<(u64, C)>);
+
+fn work<C, F>(jobs: &Mutex<Receiver<Chunk<C>>>, check: &F) -> Option<Checked<C>>
+where
+    F: Fn(&C) -> bool,
+{
+    // the lock is held only while taking a chunk
+    let (start, chunk) = jobs.lock().unwrap().recv().ok()?;
+    let len = chunk.len();
+    let failures = (start..).zip(chunk).filter(|(_, c)| !check(c)).collect();
+    Some((start, len, failures))
+}
+
+/**
+Check every configuration of `input`, reporting each finished chunk to `report`
+
+Returns the final totals.
+
+Examples:
+
+```rust
+use projgeom_rs::verifier::{verify_stream, VerifierConfig};
+let cfg = VerifierConfig { chunk_len: 100, max_pending: 2, workers: 3 };
+let mut failures = Vec::new();
+let total = verify_stream(0..10_000u64, &cfg, |n| n % 2500 != 7, |r| {
+    failures.extend(r.failures.iter().map(|(i, _)| *i));
+});
+failures.sort();
+assert_eq!(failures, [7, 2507, 5007, 7507]);
+assert_eq!((total.checked, total.failed), (10_000, 4));
+```
+*/
+pub fn verify_stream<C, I, F, R>(
+    input: I,
+    cfg: &VerifierConfig,
+    check: F,
+    mut report: R,
+) -> Progress
+where
+    C: Send,
+    I: IntoIterator<Item = C>,
+    I::IntoIter: Send,
+    F: Fn(&C) -> bool + Sync,
+    R: FnMut(&ChunkReport<C>),
+{
+    assert!(cfg.chunk_len > 0 && cfg.workers > 0);
+    let begin = Instant::now();
+    let mut progress = Progress::default();
+    let (job_tx, job_rx) = sync_channel::<Chunk<C>>(cfg.max_pending);
+    let (res_tx, res_rx) = sync_channel(cfg.max_pending);
+    let jobs = Arc::new(Mutex::new(job_rx));
+    let check = &check;
+    std::thread::scope(|s| {
+        let mut input = input.into_iter();
+        let chunk_len = cfg.chunk_len;
+        s.spawn(move || {
+            let mut start = 0;
+            loop {
+                let chunk: Vec<C> = input.by_ref().take(chunk_len).collect();
+                if chunk.is_empty() || job_tx.send((start, chunk)).is_err() {
+                    break;
+                }
+                start += chunk_len as u64;
+            }
+        });
+        for _ in 0..cfg.workers {
+            let (jobs, res_tx) = (jobs.clone(), res_tx.clone());
+            s.spawn(move || {
+                while let Some(res) = work(&jobs, check) {
+                    if res_tx.send(res).is_err() {
+                        break;
+                    }
+                }
+            });
+        }
+        // the input stops once no worker is left to take chunks, and the
+        // results end once every worker has dropped its sender
+        drop(jobs);
+        drop(res_tx);
+        for (start, len, failures) in res_rx {
+            progress.checked += len as u64;
+            progress.failed += failures.len() as u64;
+            progress.elapsed = begin.elapsed();
+            report(&ChunkReport {
+                start,
+                len,
+                failures,
+                progress,
+            });
+        }
+    });
+    progress.elapsed = begin.elapsed();
+    progress
+}
+
+/// Deterministic xorshift generator for verification inputs
+#[derive(Debug, Clone)]
+pub struct Xorshift(u64);
+
+impl Xorshift {
+    #[inline]
+    pub fn new(seed: u64) -> Self {
+        Self(seed.wrapping_mul(0x9E37_79B9_7F4A_7C15) | 1)
+    }
+
+    #[inline]
+    pub fn next_u64(&mut self) -> u64 {
+        let mut x = self.0;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        self.0 = x;
+        x
+    }
+
+    /// Uniform in [-2^bits, 2^bits], for `bits <= 126`
+    ///
+    /// Spans wider than 64 bits draw two words; narrower ones keep the
+    /// one-word sequence.
+    #[inline]
+    pub fn int(&mut self, bits: u32) -> i128 {
+        assert!(bits <= 126, "Xorshift::int: bits must be at most 126");
+        let span = (1u128 << (bits + 1)) + 1;
+        let mut x = self.next_u64() as u128;
+        if bits >= 63 {
+            x = (x << 64) | self.next_u64() as u128;
+        }
+        (x % span) as i128 - (1i128 << bits)
+    }
+
+    /// Non-zero homogeneous coordinate
+    pub fn coord(&mut self, bits: u32) -> [i128; 3] {
+        loop {
+            let c = [self.int(bits), self.int(bits), self.int(bits)];
+            if c != [0, 0, 0] {
+                return c;
+            }
+        }
+    }
+}
+
+/**
+Endless Pappus configurations: two triples of collinear points
+
+Examples:
+
+```rust
+use projgeom_rs::verifier::pappus_configs;
+use projgeom_rs::{check_pappus, PgLine, PgPoint};
+for (co1, co2) in pappus_configs(1, 4, PgPoint::new).take(100) {
+    assert!(check_pappus::<_, PgLine>(&co1, &co2));
+}
+```
+*/
+pub fn pappus_configs<P, L>(
+    seed: u64,
+    bits: u32,
+    new: fn([i128; 3]) -> P,
+) -> impl Iterator<Item = ([P; 3], [P; 3])>
+where
+    P: ProjPlane<L, i128>,
+    L: ProjPlane<P, i128>,
+{
+    let mut rng = Xorshift::new(seed);
+    core::iter::repeat_with(move || {
+        let mut triple = || {
+            let (a, b) = (new(rng.coord(bits)), new(rng.coord(bits)));
+            let c = a.plucker(&rng.int(bits), &b, &rng.int(bits));
+            [a, b, c]
+        };
+        (triple(), triple())
+    })
+}
+
+/// Endless pairs of random triangles for `check_desargue` (vertices not collinear)
+pub fn desargue_configs<P, L>(
+    seed: u64,
+    bits: u32,
+    new: fn([i128; 3]) -> P,
+) -> impl Iterator<Item = ([P; 3], [P; 3])>
+where
+    P: ProjPlanePrim<L>,
+    L: ProjPlanePrim<P>,
+{
+    let mut rng = Xorshift::new(seed);
+    core::iter::repeat_with(move || {
+        let mut tri = || loop {
+            let t = [(); 3].map(|_| new(rng.coord(bits)));
+            if !t[1].circ(&t[2]).incident(&t[0]) {
+                return t;
+            }
+        };
+        (tri(), tri())
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::pg_object::{HypLine, HypPoint, PgLine, PgPoint};
+    use crate::pg_plane::{check_desargue, check_pappus};
+
+    #[test]
+    fn test_verify_theorems() {
+        let cfg = VerifierConfig {
+            chunk_len: 64,
+            max_pending: 2,
+            workers: 4,
+        };
+        let mut chunks = 0;
+        let total = verify_stream(
+            pappus_configs(3, 6, HypPoint::new).take(5000),
+            &cfg,
+            |(co1, co2)| check_pappus::<_, HypLine>(co1, co2),
+            |r| {
+                chunks += 1;
+                assert!(r.progress.checked <= 5000);
+            },
+        );
+        assert_eq!((total.checked, total.failed), (5000, 0));
+        assert_eq!(chunks, 5000_usize.div_ceil(64));
+
+        let total = verify_stream(
+            desargue_configs(5, 4, PgPoint::new).take(1000),
+            &cfg,
+            |(t1, t2)| check_desargue::<_, PgLine>(t1, t2),
+            |_| {},
+        );
+        assert_eq!(total.failed, 0);
+        assert!(total.throughput() > 0.0);
+    }
+
+    #[test]
+    fn test_xorshift_wide_ints() {
+        let mut rng = Xorshift::new(0x2545_f491_4f6c_dd1d);
+        for bits in [1, 62, 63, 64, 100, 126] {
+            let bound = 1i128 << bits;
+            let xs: Vec<i128> = (0..200).map(|_| rng.int(bits)).collect();
+            assert!(xs.iter().all(|x| (-bound..=bound).contains(x)));
+            // wide spans reach beyond what one 64-bit word covers
+            if bits >= 64 {
+                assert!(xs.iter().any(|x| x.unsigned_abs() > 1 << 63));
+            }
+        }
+    }
+
+    #[test]
+    fn test_failures_are_indexed() {
+        let cfg = VerifierConfig {
+            chunk_len: 7,
+            max_pending: 1,
+            workers: 3,
+        };
+        // points off the line of the first two: Pappus need not hold
+        let bad = |i: u64| i % 97 == 3;
+        let configs = pappus_configs(9, 4, PgPoint::new)
+            .enumerate()
+            .map(|(i, (co1, co2))| {
+                let mut co1 = co1;
+                if bad(i as u64) {
+                    co1[2] = PgPoint::new([1, 0, 0]);
+                }
+                (i as u64, co1, co2)
+            })
+            .take(1000);
+        let mut seen = Vec::new();
+        verify_stream(
+            configs,
+            &cfg,
+            |(i, co1, co2)| !bad(*i) || check_pappus::<_, PgLine>(co1, co2),
+            |r| seen.extend(r.failures.iter().map(|(k, (i, _, _))| (*k, *i))),
+        );
+        // reported indices are positions in the input
+        assert!(!seen.is_empty());
+        assert!(seen.iter().all(|(k, i)| k == i && bad(*i)));
+    }
+}